@@ -0,0 +1,156 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <typeindex>
+#include <unordered_map>
+
+/// @brief Internal structures of the signal bus whose memory is accounted separately.
+enum class AllocationCategory : std::size_t
+{
+	Map,     ///< Nodes and bucket arrays of the event type map.
+	Lists,   ///< Per event type subscriber lists.
+	Handles, ///< Heap allocated delegate handles.
+	Queues,  ///< Storage of deferred (queued) events.
+	Count
+};
+
+/// @brief Byte and allocation counters for one slice of the accounted memory.
+/// Counters are relaxed atomics, since memory shared between forked buses may be released from another thread.
+struct AllocationCounters
+{
+	std::atomic<std::size_t> currentBytes{ 0 }; ///< Bytes currently held.
+	std::atomic<std::size_t> peakBytes{ 0 };    ///< Highest value currentBytes ever reached.
+	std::atomic<std::size_t> allocations{ 0 };  ///< Number of allocations made so far.
+	std::atomic<std::size_t> deallocations{ 0 };///< Number of deallocations made so far.
+
+	void OnAllocate(std::size_t bytes)
+	{
+		const std::size_t current = currentBytes.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+		allocations.fetch_add(1, std::memory_order_relaxed);
+
+		std::size_t peak = peakBytes.load(std::memory_order_relaxed);
+		while (current > peak && !peakBytes.compare_exchange_weak(peak, current, std::memory_order_relaxed)) {}
+	}
+
+	void OnDeallocate(std::size_t bytes)
+	{
+		currentBytes.fetch_sub(bytes, std::memory_order_relaxed);
+		deallocations.fetch_add(1, std::memory_order_relaxed);
+	}
+};
+
+/// @brief Collects allocation statistics of a signal bus, in total, per internal structure and per event type.
+class AllocationTracker
+{
+public:
+	/// @brief Records an allocation.
+	/// @param category The internal structure the memory belongs to.
+	/// @param typeCounters Counters of the event type the memory belongs to, or nullptr if it is not type specific.
+	/// @param bytes The size of the allocation.
+	void OnAllocate(AllocationCategory category, AllocationCounters* typeCounters, std::size_t bytes)
+	{
+		m_total.OnAllocate(bytes);
+		m_categories[static_cast<std::size_t>(category)].OnAllocate(bytes);
+		if (typeCounters != nullptr)
+		{
+			typeCounters->OnAllocate(bytes);
+		}
+	}
+
+	/// @brief Records a deallocation. Arguments have to match the ones of the corresponding OnAllocate call.
+	void OnDeallocate(AllocationCategory category, AllocationCounters* typeCounters, std::size_t bytes)
+	{
+		m_total.OnDeallocate(bytes);
+		m_categories[static_cast<std::size_t>(category)].OnDeallocate(bytes);
+		if (typeCounters != nullptr)
+		{
+			typeCounters->OnDeallocate(bytes);
+		}
+	}
+
+	/// @brief Returns the counters of all accounted memory.
+	const AllocationCounters& Total() const { return m_total; }
+
+	/// @brief Returns the counters of a single internal structure.
+	const AllocationCounters& ForCategory(AllocationCategory category) const
+	{
+		return m_categories[static_cast<std::size_t>(category)];
+	}
+
+	/// @brief Returns the counters of a single event type.
+	/// @tparam Event The event type to query.
+	/// @return The counters, or nullptr if nothing was ever allocated for this event type.
+	template <typename Event>
+	const AllocationCounters* ForType() const
+	{
+		const auto it = m_types.find(typeid(Event));
+		return it != m_types.end() ? &it->second : nullptr;
+	}
+
+	/// @brief Returns the (stable) counters of an event type, creating them if needed.
+	/// The bookkeeping map itself is not accounted.
+	AllocationCounters& TypeCounters(std::type_index type)
+	{
+		return m_types[type];
+	}
+
+private:
+	AllocationCounters m_total;
+	std::array<AllocationCounters, static_cast<std::size_t>(AllocationCategory::Count)> m_categories{};
+	std::unordered_map<std::type_index, AllocationCounters> m_types;
+};
+
+/// @brief Standard conforming allocator reporting every allocation to an AllocationTracker.
+/// @tparam T The type of the allocated objects.
+template <typename T>
+class TrackingAllocator
+{
+public:
+	using value_type = T;
+	using propagate_on_container_move_assignment = std::true_type;
+	using propagate_on_container_swap = std::true_type;
+
+	TrackingAllocator(AllocationTracker* tracker, AllocationCategory category, AllocationCounters* typeCounters = nullptr)
+		: m_tracker(tracker), m_typeCounters(typeCounters), m_category(category) {}
+
+	template <typename U>
+	TrackingAllocator(const TrackingAllocator<U>& other)
+		: m_tracker(other.m_tracker), m_typeCounters(other.m_typeCounters), m_category(other.m_category) {}
+
+	T* allocate(std::size_t count)
+	{
+		const std::size_t bytes = count * sizeof(T);
+		T* memory = static_cast<T*>(::operator new(bytes));
+		m_tracker->OnAllocate(m_category, m_typeCounters, bytes);
+		return memory;
+	}
+
+	void deallocate(T* memory, std::size_t count) noexcept
+	{
+		m_tracker->OnDeallocate(m_category, m_typeCounters, count * sizeof(T));
+		::operator delete(memory);
+	}
+
+	template <typename U>
+	bool operator==(const TrackingAllocator<U>& other) const
+	{
+		return m_tracker == other.m_tracker && m_typeCounters == other.m_typeCounters && m_category == other.m_category;
+	}
+
+	template <typename U>
+	bool operator!=(const TrackingAllocator<U>& other) const
+	{
+		return !(*this == other);
+	}
+
+private:
+	template <typename U>
+	friend class TrackingAllocator;
+
+	AllocationTracker* m_tracker;
+	AllocationCounters* m_typeCounters;
+	AllocationCategory m_category;
+};
@@ -0,0 +1,194 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <exception>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string_view>
+#include <utility>
+
+#include "Delegate.hpp"
+
+template <typename Signature>
+class CompactDelegate;
+
+/// @brief Exception thrown when the global stub table of a signature runs out of indices.
+class StubTableFull : public std::exception { };
+
+/// @brief An 8 byte alternative to Delegate. Instead of two pointers it stores a 32-bit index into a global
+/// stub table and a 32-bit index of the instance inside a caller-supplied object pool.
+/// A stub table entry pairs a stub function with the pool it reads instances from, so every distinct
+/// (pool, member function) combination occupies exactly one entry, registered on first bind.
+/// @tparam R The return type of the delegate.
+/// @tparam Args The argument types for the delegate.
+template <typename R, typename...Args>
+class CompactDelegate<R(Args...)>
+{
+public:
+	CompactDelegate() = default;
+
+	/// @brief Invokes the delegate with the provided arguments.
+	/// @param args The arguments to pass to the delegate.
+	/// @return The result of the invocation.
+	/// @throws BadDelegateCall if the delegate is not bound.
+	R operator()(Args...args) const
+	{
+		if (m_stub == InvalidIndex)
+		{
+			throw BadDelegateCall{};
+		}
+		const StubEntry& entry = StubTable::Get(m_stub);
+		return (*entry.stub)(entry.pool, m_instance, std::forward<Args>(args)...);
+	}
+
+	/// @brief Binds a non-const member function of an object living inside a pool.
+	/// @tparam Class The class type of the pooled objects.
+	/// @tparam MemberFunction The non-const member function to bind.
+	/// @tparam Pool Any type whose operator[](std::uint32_t) returns a Class&, e.g. std::vector<Class> or std::deque<Class>.
+	/// The pool object itself has to outlive the delegate; its elements may be reallocated.
+	/// @param pool The pool holding the instance.
+	/// @param instanceIndex The index of the instance inside the pool.
+	template <typename Class, R(Class::* MemberFunction)(Args...), typename Pool>
+	void Bind(Pool& pool, std::uint32_t instanceIndex)
+	{
+		m_stub = StubTable::Register(&MemberStub<Class, MemberFunction, Pool>, &ResolveStub<Class, Pool>, &pool);
+		SubscriberNames::Declare<&MemberStub<Class, MemberFunction, Pool>, &SubscriberNameOf<MemberFunction>>();
+		m_instance = instanceIndex;
+	}
+
+	/// @brief Binds a non-member function to the delegate.
+	/// @tparam Function The non-member function to bind.
+	template <R(*Function)(Args...)>
+	void Bind()
+	{
+		m_stub = StubTable::Register(&NonMemberStub<Function>, nullptr, nullptr);
+		SubscriberNames::Declare<&NonMemberStub<Function>, &SubscriberNameOf<Function>>();
+		m_instance = 0;
+	}
+
+	/// @brief Checks if this delegate matches a specific pooled instance and member function. Used for unbinding.
+	/// @tparam Class The class type of the pooled objects.
+	/// @tparam MemberFunction The member function to match.
+	/// @tparam Pool The pool type.
+	/// @param pool The pool holding the instance.
+	/// @param instanceIndex The index of the instance inside the pool.
+	/// @return True if the delegate matches the specified instance and member function; otherwise, false.
+	template <typename Class, R(Class::* MemberFunction)(Args...), typename Pool>
+	bool Matches(const Pool& pool, std::uint32_t instanceIndex) const
+	{
+		if (m_stub == InvalidIndex || m_instance != instanceIndex) return false;
+
+		const StubEntry& entry = StubTable::Get(m_stub);
+		return entry.stub == &MemberStub<Class, MemberFunction, Pool> && entry.pool == &pool;
+	}
+
+	/// @brief Returns the address of the bound instance, looked up in its pool, or nullptr for non-member functions.
+	const void* Instance() const
+	{
+		if (m_stub == InvalidIndex) return nullptr;
+
+		const StubEntry& entry = StubTable::Get(m_stub);
+		return entry.resolve != nullptr ? (*entry.resolve)(entry.pool, m_instance) : nullptr;
+	}
+
+	/// @brief Returns the address of the stub the delegate calls, see Delegate::StubAddress; nullptr if unbound.
+	const void* StubAddress() const
+	{
+		if (m_stub == InvalidIndex) return nullptr;
+
+		return reinterpret_cast<const void*>(StubTable::Get(m_stub).stub);
+	}
+
+	/// @brief Returns the name of the bound function, see Delegate::Name.
+	std::string_view Name() const
+	{
+		return SubscriberNames::Find(StubAddress());
+	}
+
+private:
+	using StubFunction = R(*)(void*, std::uint32_t, Args...);///< The type of the stub function used for invocation
+	using ResolveFunction = const void*(*)(void*, std::uint32_t);///< The type of the function resolving an instance address
+
+	/// @brief One entry of the global stub table.
+	struct StubEntry
+	{
+		StubFunction stub = nullptr;
+		ResolveFunction resolve = nullptr;
+		void* pool = nullptr;
+	};
+
+	/// @brief Global, append only table of stub entries for this signature.
+	/// Entries live in fixed size chunks that are never moved, so lookups need no locking.
+	class StubTable
+	{
+	public:
+		static const StubEntry& Get(std::uint32_t index)
+		{
+			return Chunks()[index / ChunkSize].load(std::memory_order_acquire)[index % ChunkSize];
+		}
+
+		/// @brief Returns the index of the entry for the given stub and pool, appending it if needed.
+		static std::uint32_t Register(StubFunction stub, ResolveFunction resolve, void* pool)
+		{
+			static std::mutex mutex;
+			static std::map<std::pair<StubFunction, void*>, std::uint32_t> indices;
+			static std::uint32_t count = 0;
+
+			std::lock_guard<std::mutex> lock(mutex);
+			const auto it = indices.find({ stub, pool });
+			if (it != indices.end()) return it->second;
+
+			if (count == ChunkSize * ChunkCount) throw StubTableFull{};
+
+			auto& chunk = Chunks()[count / ChunkSize];
+			StubEntry* entries = chunk.load(std::memory_order_relaxed);
+			if (entries == nullptr)
+			{
+				// Chunks are intentionally never freed; delegates may be invoked during static destruction.
+				entries = new StubEntry[ChunkSize];
+				chunk.store(entries, std::memory_order_release);
+			}
+			entries[count % ChunkSize] = StubEntry{ stub, resolve, pool };
+
+			indices.emplace(std::make_pair(stub, pool), count);
+			return count++;
+		}
+
+	private:
+		static constexpr std::uint32_t ChunkSize = 1024;
+		static constexpr std::uint32_t ChunkCount = 256;
+
+		static std::array<std::atomic<StubEntry*>, ChunkCount>& Chunks()
+		{
+			static std::array<std::atomic<StubEntry*>, ChunkCount> chunks{};
+			return chunks;
+		}
+	};
+
+	template <typename Class, R(Class::* MemberFunction)(Args...), typename Pool>
+	static R MemberStub(void* pool, std::uint32_t index, Args...args)
+	{
+		Class& instance = (*static_cast<Pool*>(pool))[index];
+		return (instance.*MemberFunction)(std::forward<Args>(args)...);
+	}
+
+	template <typename Class, typename Pool>
+	static const void* ResolveStub(void* pool, std::uint32_t index)
+	{
+		const Class& instance = (*static_cast<Pool*>(pool))[index];
+		return &instance;
+	}
+
+	template <R(*Function)(Args...)>
+	static R NonMemberStub(void* /* unused */, std::uint32_t /* unused */, Args...args)
+	{
+		return (*Function)(std::forward<Args>(args)...);
+	}
+
+	static constexpr std::uint32_t InvalidIndex = UINT32_MAX;
+
+	std::uint32_t m_stub = InvalidIndex; ///< Index of the entry in the global stub table.
+	std::uint32_t m_instance = 0;        ///< Index of the bound instance inside the pool of the stub entry.
+};
@@ -1,5 +1,12 @@
 #pragma once
 #include <exception>
+#include <memory>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+#include "AllocationTracker.hpp"
+#include "SubscriberName.hpp"
 
 template <typename Signature>
 class Delegate;
@@ -11,19 +18,71 @@ class BadDelegateCall : public std::exception { };
 struct IDelegateHandle
 {
 	virtual ~IDelegateHandle() = default;
+
+	/// @brief Destroys the handle and returns its memory to the allocator it was created with.
+	virtual void Destroy() noexcept = 0;
 };
 
+/// @brief Deleter releasing delegate handles through IDelegateHandle::Destroy.
+struct DelegateHandleDeleter
+{
+	void operator()(IDelegateHandle* handle) const noexcept
+	{
+		handle->Destroy();
+	}
+};
+
+/// @brief Owning pointer to a delegate handle stored inside the signal bus.
+using DelegateHandlePtr = std::unique_ptr<IDelegateHandle, DelegateHandleDeleter>;
+
 /// @brief Represents a handle for managing delegates of a specific type inside signal bus
 /// @tparam T The type of the event that the delegate is going to emit
 template <typename T>
 struct DelegateHandle : IDelegateHandle
 {
-	explicit DelegateHandle(const Delegate<void(const T&)>& delegate)
-		: m_delegate(delegate) {}
+	using Allocator = TrackingAllocator<DelegateHandle>;
+
+	DelegateHandle(const Delegate<void(const T&)>& delegate, const Allocator& allocator)
+		: m_delegate(delegate), m_allocator(allocator) {}
+
+	/// @brief Allocates a handle with the given allocator.
+	/// @param delegate The delegate to store.
+	/// @param allocator The allocator providing (and accounting) the memory of the handle.
+	/// @return The owning pointer to the created handle.
+	static DelegateHandlePtr Create(const Delegate<void(const T&)>& delegate, Allocator allocator)
+	{
+		DelegateHandle* memory = allocator.allocate(1);
+		return DelegateHandlePtr(new (memory) DelegateHandle(delegate, allocator));
+	}
+
+	/// @brief Returns the instance the stored delegate is bound to, if any.
+	const void* Instance() const
+	{
+		return m_delegate.Instance();
+	}
+
+	/// @brief Returns the stored delegate.
+	const Delegate<void(const T&)>& GetDelegate() const
+	{
+		return m_delegate;
+	}
+
+	/// @brief Creates a copy of this handle with another allocator.
+	DelegateHandlePtr Clone(const Allocator& allocator) const
+	{
+		return Create(m_delegate, allocator);
+	}
+
+	void Destroy() noexcept override
+	{
+		Allocator allocator = m_allocator;
+		this->~DelegateHandle();
+		allocator.deallocate(this, 1);
+	}
 
 	/// @brief Invokes the stored delegate with the provided event.
    /// @param event The data to pass to the delegate.
-	void Emit(T event)
+	void Emit(const T& event)
 	{
 		m_delegate(event);
 	}
@@ -36,10 +95,11 @@ struct DelegateHandle : IDelegateHandle
 	template <typename Class, void (Class::* MemberFunction)(const T&)>
 	bool Matches(const Class* instance) const
 	{
-		return m_delegate.Matches<Class, MemberFunction>(instance);
+		return m_delegate.template Matches<Class, MemberFunction>(instance);
 	}
 private:
 	Delegate<void(const T&)> m_delegate;
+	Allocator m_allocator;
 };
 
 
@@ -64,7 +124,33 @@ public:
 		{
 			throw BadDelegateCall{};
 		}
-		return (*m_stub)(m_instance, args...);
+		return (*m_stub)(m_instance, std::forward<Args>(args)...);
+	}
+
+	/// @brief Checks whether the delegate is bound to anything.
+	bool IsBound() const
+	{
+		return m_stub != nullptr;
+	}
+
+	/// @brief Returns the instance the delegate is bound to; nullptr for non-member functions, the shared copy of the lambda for lambdas.
+	const void* Instance() const
+	{
+		return m_instance;
+	}
+
+	/// @brief Returns the address of the stub the delegate calls. Every bound function has its own stub,
+	/// so a symbolizer resolves it to the function; nullptr if unbound.
+	const void* StubAddress() const
+	{
+		return reinterpret_cast<const void*>(m_stub);
+	}
+
+	/// @brief Returns the name of the bound function, e.g. "Player::OnDamage", or an empty view if unbound or
+	/// built with SIGNALBUS_SUBSCRIBER_NAMES=0. Takes a lock; meant for instrumentation, not for the emit path.
+	std::string_view Name() const
+	{
+		return SubscriberNames::Find(StubAddress());
 	}
 
 	/// @brief Checks if this delegate matches a specific instance and member function. Used for unbinding and == checks.
@@ -75,10 +161,36 @@ public:
 	template <typename Class, R(Class::* MemberFunction)(Args...)>
 	bool Matches(const Class* instance) const
 	{
-		return m_instance == instance && m_stub == [](const void* p, Args... args) -> R {
-			auto* cls = const_cast<Class*>(static_cast<const Class*>(p));
-			return (cls->*MemberFunction)(args...);
-			};
+		return m_instance == instance && m_stub == &MemberStub<Class, MemberFunction>;
+	}
+
+	/// @brief Checks if this delegate matches a specific instance and const member function.
+	/// @tparam Class The class type of the instance.
+	/// @tparam MemberFunction The const member function to match.
+	/// @param instance The instance to check for a match.
+	/// @return True if the delegate matches the specified instance and member function; otherwise, false.
+	template <typename Class, R(Class::* MemberFunction)(Args...) const>
+	bool Matches(const Class* instance) const
+	{
+		return m_instance == instance && m_stub == &ConstMemberStub<Class, MemberFunction>;
+	}
+
+	/// @brief Checks if this delegate is bound to a specific non-member function.
+	/// @tparam Function The non-member function to match.
+	/// @return True if the delegate is bound to the function; otherwise, false.
+	template <R(*Function)(Args...)>
+	bool Matches() const
+	{
+		return m_stub == &NonMemberStub<Function>;
+	}
+
+	/// @brief Checks if this delegate is bound to a captureless lambda of the given type.
+	/// @tparam Lambda The type of the lambda to match. All lambdas of one type behave the same, so the type identifies it.
+	/// @return True if the delegate is bound to a lambda of this type; otherwise, false.
+	template <typename Lambda>
+	bool Matches(const Lambda& /* unused */) const
+	{
+		return m_stub == &LambdaStub<Lambda>;
 	}
 
 	/// @brief Binds a non-member function to the delegate.
@@ -87,9 +199,8 @@ public:
 	void Bind()
 	{
 		m_instance = nullptr;
-		m_stub = static_cast<StubFunction>([](const void*, Args...args) -> R {
-			return (*Function)(args...);
-			});
+		m_stub = &NonMemberStub<Function>;
+		SubscriberNames::Declare<&NonMemberStub<Function>, &SubscriberNameOf<Function>>();
 	}
 
 	/// @brief Binds a const member function to the delegate.
@@ -97,14 +208,11 @@ public:
 	/// @tparam MemberFunction The const member function to bind.
 	/// @param classPointer The instance to bind to.
 	template <typename Class, R(Class::* MemberFunction)(Args...) const>
-	Delegate Bind(const Class* classPointer)
+	void Bind(const Class* classPointer)
 	{
 		m_instance = classPointer; // store the class pointer
-		m_stub = static_cast<StubFunction>([](const void* p, Args...args) -> R {
-			const auto* castedClass = static_cast<const Class*>(p);
-
-			return (castedClass->*MemberFunction)(args...);
-			});
+		m_stub = &ConstMemberStub<Class, MemberFunction>;
+		SubscriberNames::Declare<&ConstMemberStub<Class, MemberFunction>, &SubscriberNameOf<MemberFunction>>();
 	}
 
 	/// @brief Binds a non-const member function to the delegate.
@@ -114,12 +222,25 @@ public:
 	template <typename Class, R(Class::* MemberFunction)(Args...)>
 	auto Bind(Class* c) -> void {
 		m_instance = c; // store the class pointer
-		m_stub = static_cast<StubFunction>([](const void* p, Args...args) -> R {
-			// Safe, because we know the pointer was bound to a non-const instance
-			auto* cls = const_cast<Class*>(static_cast<const Class*>(p));
+		m_stub = &MemberStub<Class, MemberFunction>;
+		SubscriberNames::Declare<&MemberStub<Class, MemberFunction>, &SubscriberNameOf<MemberFunction>>();
+	}
 
-			return (cls->*MemberFunction)(args...);
-			});
+	/// @brief Binds a captureless lambda to the delegate. The lambda is called directly from the stub, without
+	/// going through a function pointer, and nothing is allocated.
+	/// @tparam Lambda The type of the lambda.
+	/// @param lambda The lambda to bind.
+	template <typename Lambda>
+	void Bind(const Lambda& lambda)
+	{
+		static_assert(std::is_empty_v<Lambda> && std::is_convertible_v<Lambda, R(*)(Args...)>,
+			"Only captureless lambdas can be bound without allocation");
+
+		// Captureless lambdas of one type carry no state, so a single copy can serve every delegate bound to that type
+		static const Lambda stored = lambda;
+		m_instance = &stored;
+		m_stub = &LambdaStub<Lambda>;
+		SubscriberNames::Declare<&LambdaStub<Lambda>, &SubscriberTypeNameOf<Lambda>>();
 	}
 
 private:
@@ -130,7 +251,33 @@ private:
 	template <R(*Function)(Args...)>
 	static R NonMemberStub(const void* /* unused */, Args...args)
 	{
-		return (*Function)(args...);
+		return (*Function)(std::forward<Args>(args)...);
+	}
+
+	/// @brief Helper function for binding non-const member functions.
+	template <typename Class, R(Class::* MemberFunction)(Args...)>
+	static R MemberStub(const void* p, Args...args)
+	{
+		// Safe, because we know the pointer was bound to a non-const instance
+		auto* cls = const_cast<Class*>(static_cast<const Class*>(p));
+
+		return (cls->*MemberFunction)(std::forward<Args>(args)...);
+	}
+
+	/// @brief Helper function for binding const member functions.
+	template <typename Class, R(Class::* MemberFunction)(Args...) const>
+	static R ConstMemberStub(const void* p, Args...args)
+	{
+		const auto* castedClass = static_cast<const Class*>(p);
+
+		return (castedClass->*MemberFunction)(std::forward<Args>(args)...);
+	}
+
+	/// @brief Helper function for binding captureless lambdas.
+	template <typename Lambda>
+	static R LambdaStub(const void* p, Args...args)
+	{
+		return (*static_cast<const Lambda*>(p))(std::forward<Args>(args)...);
 	}
 
 	using StubFunction = R(*)(const void*, Args...);///< The type of the stub function used for invocation
@@ -0,0 +1,301 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "AllocationTracker.hpp"
+#include "CompactDelegate.hpp"
+#include "Delegate.hpp"
+#include "HandlerActivity.hpp"
+#include "SubscriptionGroup.hpp"
+#include "SubscriptionNode.hpp"
+
+/// @brief Non-owning, allocation free reference to a predicate over subscriber instances,
+/// used to pass predicates through the untyped channel interface.
+class InstancePredicate
+{
+public:
+	template <typename Predicate>
+	explicit InstancePredicate(const Predicate& predicate)
+		: m_predicate(&predicate), m_test([](const void* p, const void* instance) -> bool {
+			return (*static_cast<const Predicate*>(p))(instance);
+			}) {}
+
+	bool operator()(const void* instance) const
+	{
+		return (*m_test)(m_predicate, instance);
+	}
+
+private:
+	const void* m_predicate;
+	bool(*m_test)(const void*, const void*);
+};
+
+/// @brief Pairs the subscription groups of a bus with their copies in a fork of the bus.
+using GroupMapping = std::vector<std::pair<const SubscriptionGroupState*, std::shared_ptr<SubscriptionGroupState>>>;
+
+/// @brief Abstract base class of the per event type subscriber storage inside the signal bus.
+struct IEventChannel
+{
+	virtual ~IEventChannel() = default;
+
+	/// @brief Creates a deep copy of the channel whose memory is reported to another tracker.
+	/// @param tracker The tracker to report to.
+	/// @param typeCounters The counters of the channel's event type inside the tracker.
+	virtual std::shared_ptr<IEventChannel> CloneChannel(AllocationTracker* tracker, AllocationCounters* typeCounters) const = 0;
+
+	/// @brief Checks whether the channel has no subscribers left.
+	virtual bool Empty() const = 0;
+
+	/// @brief Checks whether the channel holds subscribers of a subscription group.
+	virtual bool HasGroup(const SubscriptionGroupState* group) const = 0;
+
+	/// @brief Checks whether the channel holds subscribers of any subscription group.
+	virtual bool HasGroups() const = 0;
+
+	/// @brief Moves the group subscribers over to the copies of their groups. Used on the copied channels of a fork.
+	virtual void RemapGroups(const GroupMapping& mapping) = 0;
+
+	/// @brief Checks whether the channel has a receiver for sent events.
+	virtual bool HasReceiver() const = 0;
+
+	/// @brief Unbinds the receiver for sent events. Used on the copied channels of a fork, which must not share the single owner.
+	virtual void UnbindReceiver() = 0;
+
+	/// @brief Removes all subscribers of a subscription group.
+	virtual void EraseGroup(const SubscriptionGroupState* group) = 0;
+
+	/// @brief Checks whether any subscriber is bound to an instance matching the predicate.
+	virtual bool AnyInstance(const InstancePredicate& predicate) const = 0;
+
+	/// @brief Removes every subscriber bound to an instance matching the predicate, compacting each list once.
+	/// @return The number of removed subscribers.
+	virtual std::size_t EraseInstances(const InstancePredicate& predicate) = 0;
+
+	/// @brief Unlinks the intrusive nodes of the channel's event type bound to an instance matching the predicate.
+	/// @return The number of unlinked nodes.
+	virtual std::size_t UnlinkInstances(IntrusiveSubscriberList& nodes, const InstancePredicate& predicate) const = 0;
+};
+
+/// @brief Shared pointer to a channel. Channels are shared between forked buses and copied on write.
+using EventChannelPtr = std::shared_ptr<IEventChannel>;
+
+/// @brief All subscribers of a single event type.
+/// @tparam T The type of the event.
+template <typename T>
+struct EventChannel : IEventChannel
+{
+	using Allocator = TrackingAllocator<EventChannel>;
+	using HandleList = std::vector<DelegateHandlePtr, TrackingAllocator<DelegateHandlePtr>>;
+	using DelegateList = std::vector<Delegate<void(const T&)>, TrackingAllocator<Delegate<void(const T&)>>>;
+	using CompactList = std::vector<CompactDelegate<void(const T&)>, TrackingAllocator<CompactDelegate<void(const T&)>>>;
+
+	/// @brief The subscribers of one subscription group, kept together so a muted group is skipped as a whole.
+	struct GroupSegment
+	{
+		std::shared_ptr<SubscriptionGroupState> group;
+		DelegateList delegates;
+	};
+	using GroupList = std::vector<GroupSegment, TrackingAllocator<GroupSegment>>;
+
+	explicit EventChannel(const Allocator& allocator)
+		: handles(allocator), delegates(allocator), compact(allocator), groups(allocator) {}
+
+	/// @brief Allocates an empty channel. The channel and its lists are accounted as AllocationCategory::Lists.
+	/// @param tracker The tracker to report to.
+	/// @param typeCounters The counters of the event type T inside the tracker.
+	static std::shared_ptr<EventChannel> Create(AllocationTracker* tracker, AllocationCounters* typeCounters)
+	{
+		const Allocator allocator(tracker, AllocationCategory::Lists, typeCounters);
+		return std::allocate_shared<EventChannel>(allocator, allocator);
+	}
+
+	/// @brief Creates a deep copy of this channel whose memory is reported to another tracker.
+	/// @param tracker The tracker to report to.
+	/// @param typeCounters The counters of the event type T inside the tracker.
+	std::shared_ptr<EventChannel> Clone(AllocationTracker* tracker, AllocationCounters* typeCounters) const
+	{
+		auto copy = Create(tracker, typeCounters);
+		const typename DelegateHandle<T>::Allocator handleAllocator(tracker, AllocationCategory::Handles, typeCounters);
+
+		copy->handles.reserve(handles.size());
+		for (const auto& handle : handles)
+		{
+			copy->handles.push_back(static_cast<const DelegateHandle<T>*>(handle.get())->Clone(handleAllocator));
+		}
+		copy->delegates.assign(delegates.begin(), delegates.end());
+		copy->compact.assign(compact.begin(), compact.end());
+		copy->receiver = receiver;
+
+		copy->groups.reserve(groups.size());
+		for (const auto& segment : groups)
+		{
+			copy->groups.push_back(GroupSegment{ segment.group, DelegateList(segment.delegates, copy->delegates.get_allocator()) });
+		}
+		return copy;
+	}
+
+	std::shared_ptr<IEventChannel> CloneChannel(AllocationTracker* tracker, AllocationCounters* typeCounters) const override
+	{
+		return Clone(tracker, typeCounters);
+	}
+
+	bool HasGroup(const SubscriptionGroupState* group) const override
+	{
+		return std::any_of(groups.begin(), groups.end(), [group](const GroupSegment& segment) { return segment.group.get() == group; });
+	}
+
+	bool HasGroups() const override
+	{
+		return !groups.empty();
+	}
+
+	void RemapGroups(const GroupMapping& mapping) override
+	{
+		for (auto& segment : groups)
+		{
+			const auto it = std::find_if(mapping.begin(), mapping.end(),
+				[&segment](const auto& pair) { return pair.first == segment.group.get(); });
+			if (it != mapping.end())
+			{
+				segment.group = it->second;
+			}
+		}
+	}
+
+	bool HasReceiver() const override
+	{
+		return receiver.IsBound();
+	}
+
+	void UnbindReceiver() override
+	{
+		receiver = {};
+	}
+
+	void EraseGroup(const SubscriptionGroupState* group) override
+	{
+		groups.erase(
+			std::remove_if(groups.begin(), groups.end(), [group](const GroupSegment& segment) { return segment.group.get() == group; }),
+			groups.end());
+	}
+
+	bool AnyInstance(const InstancePredicate& predicate) const override
+	{
+		const auto delegateMatches = [&predicate](const auto& delegate) { return predicate(delegate.Instance()); };
+		const auto handleMatches = [&predicate](const DelegateHandlePtr& handle) {
+			return predicate(static_cast<const DelegateHandle<T>*>(handle.get())->Instance());
+			};
+
+		return (receiver.IsBound() && predicate(receiver.Instance()))
+			|| std::any_of(handles.begin(), handles.end(), handleMatches)
+			|| std::any_of(delegates.begin(), delegates.end(), delegateMatches)
+			|| std::any_of(compact.begin(), compact.end(), delegateMatches)
+			|| std::any_of(groups.begin(), groups.end(), [&delegateMatches](const GroupSegment& segment) {
+				return std::any_of(segment.delegates.begin(), segment.delegates.end(), delegateMatches);
+				});
+	}
+
+	std::size_t EraseInstances(const InstancePredicate& predicate) override
+	{
+		const auto delegateMatches = [&predicate](const auto& delegate) { return predicate(delegate.Instance()); };
+		const std::size_t before = Count();
+
+		handles.erase(
+			std::remove_if(handles.begin(), handles.end(), [&predicate](const DelegateHandlePtr& handle) {
+				return predicate(static_cast<const DelegateHandle<T>*>(handle.get())->Instance());
+				}),
+			handles.end());
+		compact.erase(std::remove_if(compact.begin(), compact.end(), delegateMatches), compact.end());
+		EraseDelegates(delegateMatches);
+		if (receiver.IsBound() && predicate(receiver.Instance()))
+		{
+			receiver = {};
+		}
+
+		return before - Count();
+	}
+
+	std::size_t UnlinkInstances(IntrusiveSubscriberList& nodes, const InstancePredicate& predicate) const override
+	{
+		return nodes.UnlinkIf<T>(predicate);
+	}
+
+	/// @brief Returns the number of subscribers in the channel, intrusive nodes excluded.
+	std::size_t Count() const
+	{
+		std::size_t count = handles.size() + delegates.size() + compact.size() + (receiver.IsBound() ? 1 : 0);
+		for (const auto& segment : groups)
+		{
+			count += segment.delegates.size();
+		}
+		return count;
+	}
+
+	/// @brief Returns the subscribers of a group, adding an empty segment for it if needed.
+	DelegateList& GroupDelegates(const std::shared_ptr<SubscriptionGroupState>& group)
+	{
+		for (auto& segment : groups)
+		{
+			if (segment.group == group) return segment.delegates;
+		}
+		groups.push_back(GroupSegment{ group, DelegateList(delegates.get_allocator()) });
+		return groups.back().delegates;
+	}
+
+	/// @brief Removes the delegates matching a predicate from the ungrouped and grouped lists; drops emptied group segments.
+	template <typename Predicate>
+	void EraseDelegates(Predicate predicate)
+	{
+		delegates.erase(std::remove_if(delegates.begin(), delegates.end(), predicate), delegates.end());
+		for (auto& segment : groups)
+		{
+			segment.delegates.erase(std::remove_if(segment.delegates.begin(), segment.delegates.end(), predicate), segment.delegates.end());
+		}
+		groups.erase(
+			std::remove_if(groups.begin(), groups.end(), [](const GroupSegment& segment) { return segment.delegates.empty(); }),
+			groups.end());
+	}
+
+	/// @brief Invokes every subscriber of the channel, one storage kind after the other: handles, by-value delegates,
+	/// compact delegates, then the group segments. Bind order is only kept within each kind.
+	/// @param event The event to pass to the subscribers.
+	void Emit(const T& event) const
+	{
+		for (const auto& handle : handles)
+		{
+			InvokeHandler(static_cast<DelegateHandle<T>*>(handle.get())->GetDelegate(), event);
+		}
+		for (const auto& delegate : delegates)
+		{
+			InvokeHandler(delegate, event);
+		}
+		for (const auto& delegate : compact)
+		{
+			InvokeHandler(delegate, event);
+		}
+		for (const auto& segment : groups)
+		{
+			if (segment.group->muted.load(std::memory_order_relaxed)) continue;
+
+			for (const auto& delegate : segment.delegates)
+			{
+				InvokeHandler(delegate, event);
+			}
+		}
+	}
+
+	bool Empty() const override
+	{
+		return handles.empty() && delegates.empty() && compact.empty() && groups.empty() && !receiver.IsBound();
+	}
+
+	HandleList handles;     ///< Subscribers bound through heap allocated delegate handles.
+	DelegateList delegates; ///< Free functions, const member functions, captureless lambdas and member functions bound with BindMany, stored by value.
+	CompactList compact;    ///< Subscribers bound as 8 byte compact delegates, stored contiguously.
+	GroupList groups;       ///< Subscribers bound into subscription groups, one segment per group.
+	Delegate<void(T&&)> receiver; ///< The single owner events sent with SignalBus::Send are moved into, if any.
+};
@@ -0,0 +1,924 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "AllocationTracker.hpp"
+
+/// @brief Set to 0 to compile out the enqueue-to-handler latency histograms of queued events.
+#ifndef SIGNALBUS_QUEUE_LATENCY
+#define SIGNALBUS_QUEUE_LATENCY 1
+#endif
+
+#if SIGNALBUS_QUEUE_LATENCY
+#include <atomic>
+
+#include "LatencyHistogram.hpp"
+#endif
+
+/// @brief Limits how much work a single SignalBus::DispatchFor call does. Whatever is left stays queued for the next call.
+struct DispatchBudget
+{
+	std::size_t maxEvents = std::numeric_limits<std::size_t>::max();          ///< Dispatch at most this many events.
+	std::chrono::nanoseconds maxTime = std::chrono::nanoseconds::max();       ///< Stop starting new events after this long.
+
+	/// @brief Budget limited by the number of events.
+	static DispatchBudget Events(std::size_t count)
+	{
+		DispatchBudget budget;
+		budget.maxEvents = count;
+		return budget;
+	}
+
+	/// @brief Budget limited by time. At least one event is dispatched per call, so a backlog always shrinks.
+	static DispatchBudget Time(std::chrono::nanoseconds duration)
+	{
+		DispatchBudget budget;
+		budget.maxTime = duration;
+		return budget;
+	}
+};
+
+/// @brief Priority lane of a queued event. Lanes are served strictly in this order, so under overload
+/// lower lanes wait while higher ones have events.
+enum class QueuePriority : std::uint8_t
+{
+	High,
+	Normal,
+	Low,
+	Count
+};
+
+/// @brief How an event is queued by SignalBus::Enqueue.
+struct EnqueueOptions
+{
+	QueuePriority priority = QueuePriority::Normal;
+
+	/// @brief Latest time the event may be dispatched. Inside its lane, events with a deadline are dispatched
+	/// earliest deadline first and ahead of events without one; an event still queued after its deadline is dropped.
+	std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::time_point::max();
+
+	/// @brief Options for an event that is worthless unless dispatched within the given time from now.
+	static EnqueueOptions Within(std::chrono::steady_clock::duration timeout, QueuePriority priority = QueuePriority::Normal)
+	{
+		EnqueueOptions options;
+		options.priority = priority;
+		options.deadline = std::chrono::steady_clock::now() + timeout;
+		return options;
+	}
+};
+
+/// @brief Duplicate suppression of queued events. Disabled unless the event type declares
+/// static constexpr bool DeduplicateWhileQueued = true; then enqueueing an event equal to one that is
+/// still pending is dropped. Equality is the type's Hash() member and operator== if it declares Hash(),
+/// otherwise a byte compare, which requires a trivially copyable type (and misses duplicates differing only in padding).
+/// @tparam T The type of the event.
+template <typename T, typename = void>
+struct EventDedupOf
+{
+	static constexpr bool Enabled = false;
+};
+
+template <typename T, typename = void>
+struct HasEventHash : std::false_type { };
+
+template <typename T>
+struct HasEventHash<T, std::void_t<decltype(std::declval<const T&>().Hash())>> : std::true_type { };
+
+template <typename T>
+struct EventDedupOf<T, std::enable_if_t<T::DeduplicateWhileQueued>>
+{
+	static constexpr bool Enabled = true;
+
+	static std::size_t Hash(const T& event)
+	{
+		if constexpr (HasEventHash<T>::value)
+		{
+			return static_cast<std::size_t>(event.Hash());
+		}
+		else
+		{
+			static_assert(std::is_trivially_copyable_v<T>, "Deduplicated events have to declare Hash() and operator== or be trivially copyable");
+
+			// FNV-1a
+			const auto* bytes = reinterpret_cast<const unsigned char*>(&event);
+			std::uint64_t hash = 14695981039346656037ull;
+			for (std::size_t i = 0; i < sizeof(T); ++i)
+			{
+				hash = (hash ^ bytes[i]) * 1099511628211ull;
+			}
+			return static_cast<std::size_t>(hash);
+		}
+	}
+
+	static bool Equal(const T& left, const T& right)
+	{
+		if constexpr (HasEventHash<T>::value)
+		{
+			return left == right;
+		}
+		else
+		{
+			return std::memcmp(&left, &right, sizeof(T)) == 0;
+		}
+	}
+};
+
+#if SIGNALBUS_QUEUE_LATENCY
+/// @brief Dense index of an event type, assigned on first use, for per-type tables of the queue.
+inline std::uint32_t NextQueuedTypeIndex()
+{
+	static std::atomic<std::uint32_t> next{ 0 };
+	return next.fetch_add(1, std::memory_order_relaxed);
+}
+
+template <typename Event>
+std::uint32_t QueuedTypeIndex()
+{
+	static const std::uint32_t index = NextQueuedTypeIndex();
+	return index;
+}
+#endif
+
+/// @brief Backlog metrics of the event queue of a bus.
+struct QueueStats
+{
+	std::size_t pending = 0;                        ///< Events waiting for dispatch, cancelled ones not yet skipped included.
+	std::chrono::nanoseconds oldestPendingAge{ 0 }; ///< How long the oldest pending event has been waiting.
+	std::uint64_t dispatched = 0;                   ///< Events dispatched so far.
+	std::chrono::nanoseconds maxDispatchAge{ 0 };   ///< Longest time an event waited between enqueue and dispatch.
+	std::chrono::nanoseconds totalDispatchAge{ 0 }; ///< Sum of the waiting times of all dispatched events.
+	std::uint64_t expired = 0;                      ///< Events dropped because their deadline passed before dispatch.
+	std::uint64_t cancelled = 0;                    ///< Cancelled events skipped by dispatch.
+	std::uint64_t deduplicated = 0;                 ///< Enqueued events dropped as duplicates of pending ones.
+};
+
+/// @brief Cancellation state of a queue slot. The generation changes when the dispatch of the event starts
+/// and whenever the slot is freed, which invalidates the handles of the event it held.
+struct QueueSlotState
+{
+	std::uint32_t generation = 0;
+	bool cancelled = false;
+};
+
+/// @brief Handle to a queued event, returned by SignalBus::Enqueue. Small and trivially copyable.
+/// Has to be dropped before the bus that queued the event is destroyed.
+class QueuedEvent
+{
+public:
+	QueuedEvent() = default;
+
+	/// @brief Checks whether the event is still waiting for dispatch and has not been cancelled.
+	/// False from the moment its dispatch starts, also inside its own handlers.
+	bool IsPending() const
+	{
+		return m_state != nullptr && m_state->generation == m_generation && !m_state->cancelled;
+	}
+
+	/// @brief Retracts the event in O(1). Its slot is only marked dead; dispatch skips and frees it.
+	/// @return False if the event was already dispatched or is being dispatched, dropped or cancelled.
+	bool Cancel()
+	{
+		if (!IsPending()) return false;
+
+		m_state->cancelled = true;
+		return true;
+	}
+
+private:
+	friend class EventQueue;
+
+	QueuedEvent(QueueSlotState* state, std::uint32_t generation)
+		: m_state(state), m_generation(generation) {}
+
+	QueueSlotState* m_state = nullptr;
+	std::uint32_t m_generation = 0;
+};
+
+/// @brief Type-erased queue of deferred events, owned by a SignalBus. Events of all types share one lane
+/// per QueuePriority; inside a lane, events with a deadline are dispatched earliest deadline first (EDF),
+/// the others in the order they were enqueued, whatever their type.
+/// Slots live in fixed chunks and are reused; events up to InlineSize bytes are stored inside their slot,
+/// larger ones in a separate allocation. All memory is accounted as AllocationCategory::Queues.
+/// Not thread safe, like the bus itself.
+class EventQueue
+{
+public:
+	using Clock = std::chrono::steady_clock;
+
+	/// @brief Delivers a queued event, e.g. by emitting it on a bus.
+	using DispatchFunction = void(*)(void* target, const void* event);
+
+	/// @brief Events up to this size are stored inside their slot without an extra allocation.
+	static constexpr std::size_t InlineSize = 64;
+
+	explicit EventQueue(AllocationTracker* tracker)
+		: m_tracker(tracker),
+		  m_chunks(TrackingAllocator<SlotChunk*>(tracker, AllocationCategory::Queues)),
+		  m_free(TrackingAllocator<std::uint32_t>(tracker, AllocationCategory::Queues)),
+		  m_lanes{ { Lane(tracker), Lane(tracker), Lane(tracker) } },
+		  m_deferred(TrackingAllocator<DeferredEntry>(tracker, AllocationCategory::Queues)),
+		  m_pending(TrackingAllocator<PendingEntry>(tracker, AllocationCategory::Queues))
+#if SIGNALBUS_QUEUE_LATENCY
+		, m_latency(TrackingAllocator<LatencyHistogram>(tracker, AllocationCategory::Queues))
+#endif
+	{
+	}
+
+	EventQueue(const EventQueue&) = delete;
+	auto operator=(const EventQueue&)->EventQueue & = delete;
+
+	EventQueue(EventQueue&& other) noexcept
+		: m_tracker(other.m_tracker),
+		  m_chunks(std::move(other.m_chunks)),
+		  m_free(std::move(other.m_free)),
+		  m_lanes(std::move(other.m_lanes)),
+		  m_size(other.m_size),
+		  m_nextSequence(other.m_nextSequence),
+		  m_deferred(std::move(other.m_deferred)),
+		  m_pending(std::move(other.m_pending)),
+		  m_pendingCount(other.m_pendingCount),
+		  m_stats(other.m_stats)
+#if SIGNALBUS_QUEUE_LATENCY
+		, m_latency(std::move(other.m_latency))
+#endif
+	{
+		other.m_chunks.clear();
+		other.m_size = 0;
+		other.m_pendingCount = 0;
+	}
+
+	void Swap(EventQueue& other) noexcept
+	{
+		std::swap(m_tracker, other.m_tracker);
+		m_chunks.swap(other.m_chunks);
+		m_free.swap(other.m_free);
+		for (std::size_t i = 0; i < m_lanes.size(); ++i)
+		{
+			m_lanes[i].Swap(other.m_lanes[i]);
+		}
+		std::swap(m_size, other.m_size);
+		std::swap(m_nextSequence, other.m_nextSequence);
+		m_deferred.swap(other.m_deferred);
+		m_pending.swap(other.m_pending);
+		std::swap(m_pendingCount, other.m_pendingCount);
+#if SIGNALBUS_QUEUE_LATENCY
+		m_latency.swap(other.m_latency);
+#endif
+		std::swap(m_stats, other.m_stats);
+	}
+
+	~EventQueue()
+	{
+		Clear();
+
+		TrackingAllocator<SlotChunk> allocator(m_tracker, AllocationCategory::Queues);
+		for (SlotChunk* chunk : m_chunks)
+		{
+			chunk->~SlotChunk();
+			allocator.deallocate(chunk, 1);
+		}
+	}
+
+	/// @brief Queues a copy of an event.
+	/// @tparam Event The type of the event.
+	/// @param event The event to copy into the queue.
+	/// @param dispatch The function delivering the event once it is dispatched.
+	/// @param options The lane and deadline of the event.
+	/// @return A handle to cancel the event with; for a dropped duplicate the handle of the pending event.
+	template <typename Event>
+	QueuedEvent Push(const Event& event, DispatchFunction dispatch, const EnqueueOptions& options)
+	{
+		static_assert(static_cast<std::size_t>(QueuePriority::Count) == 3, "Update the lane initialization of the constructor");
+
+		std::size_t hash = 0;
+		if constexpr (EventDedupOf<Event>::Enabled)
+		{
+			hash = EventDedupOf<Event>::Hash(event);
+			const std::uint32_t duplicate = FindPending(hash, &EqualStub<Event>, &event);
+			if (duplicate != NoSlot)
+			{
+				++m_stats.deduplicated;
+				Slot& pending = SlotAt(duplicate);
+				return QueuedEvent(&pending.state, pending.state.generation);
+			}
+			ReservePending(); // So the insert below can not throw
+		}
+
+#if SIGNALBUS_QUEUE_LATENCY
+		const std::uint32_t typeIndex = QueuedTypeIndex<Event>();
+		if (typeIndex >= m_latency.size())
+		{
+			m_latency.resize(typeIndex + 1);
+		}
+#endif
+
+		Lane& lane = m_lanes[static_cast<std::size_t>(options.priority)];
+		const bool hasDeadline = options.deadline != Clock::time_point::max();
+		if (hasDeadline)
+		{
+			// So the push below, parking entries during a dispatch and putting them back can not throw
+			Reserve(lane.deadlines, lane.deadlines.size() + m_deferred.size() + 1);
+			std::size_t deadlineCount = m_deferred.size() + 1;
+			for (const Lane& each : m_lanes)
+			{
+				deadlineCount += each.deadlines.size();
+			}
+			Reserve(m_deferred, deadlineCount);
+		}
+
+		const std::uint32_t index = AcquireSlot();
+		Slot& slot = SlotAt(index);
+		try
+		{
+			Store(slot, event);
+		}
+		catch (...)
+		{
+			m_free.push_back(index);
+			throw;
+		}
+
+		slot.dispatch = dispatch;
+		slot.equal = nullptr;
+		slot.enqueued = Clock::now();
+		slot.deadline = options.deadline;
+		slot.sequence = m_nextSequence++;
+#if SIGNALBUS_QUEUE_LATENCY
+		slot.typeIndex = typeIndex;
+		slot.enqueuedTicks = ReadTimestamp();
+#endif
+		if (hasDeadline)
+		{
+			lane.deadlines.push_back(DeadlineEntry{ options.deadline, slot.sequence, index });
+			std::push_heap(lane.deadlines.begin(), lane.deadlines.end(), &LaterDeadline);
+		}
+		else
+		{
+			try
+			{
+				lane.fifo.PushBack(index);
+			}
+			catch (...)
+			{
+				Release(index);
+				throw;
+			}
+		}
+		++m_size;
+
+		if constexpr (EventDedupOf<Event>::Enabled)
+		{
+			slot.equal = &EqualStub<Event>;
+			slot.hash = hash;
+			InsertPending(hash, index);
+		}
+		return QueuedEvent(&slot.state, slot.state.generation);
+	}
+
+	/// @brief Dispatches queued events, highest lane first, until the budget is used up or the queue is empty.
+	/// Cancelled events and events whose deadline has passed are dropped on the way without counting against the event budget.
+	/// A call only handles events queued before it started. Events the handlers enqueue wait for the next call, even with
+	/// a higher priority or an earlier deadline, so handlers that enqueue can neither keep a call going nor starve older events.
+	/// @param target Passed on to the dispatch function of every event.
+	/// @param budget The budget of this call.
+	/// @return The number of dispatched events.
+	std::size_t Dispatch(void* target, const DispatchBudget& budget)
+	{
+		const Clock::time_point start = Clock::now();
+		const std::uint64_t end = m_nextSequence;
+		std::size_t dispatched = 0;
+
+		try
+		{
+			dispatched = DispatchUntil(target, budget, start, end);
+		}
+		catch (...)
+		{
+			RestoreDeferred();
+			throw;
+		}
+		RestoreDeferred();
+		return dispatched;
+	}
+
+	/// @brief Destroys every queued event without dispatching it.
+	void Clear()
+	{
+		RestoreDeferred(); // A handler may clear the queue in the middle of a dispatch
+		while (m_size > 0)
+		{
+			Release(PopNext(m_nextSequence));
+		}
+	}
+
+	std::size_t Size() const
+	{
+		return m_size;
+	}
+
+#if SIGNALBUS_QUEUE_LATENCY
+	/// @brief Returns the distribution of the time events of a type waited between Enqueue and the start of their dispatch.
+	/// @tparam Event The type of the event.
+	template <typename Event>
+	LatencyHistogram Latency() const
+	{
+		const std::uint32_t typeIndex = QueuedTypeIndex<Event>();
+		return typeIndex < m_latency.size() ? m_latency[typeIndex] : LatencyHistogram();
+	}
+#endif
+
+	/// @brief Returns the backlog metrics. Finding the oldest pending event scans the events queued with a deadline.
+	QueueStats Stats() const
+	{
+		QueueStats stats = m_stats;
+		stats.pending = m_size;
+		if (m_size == 0) return stats;
+
+		Clock::time_point oldest = Clock::time_point::max();
+		for (const Lane& lane : m_lanes)
+		{
+			if (!lane.fifo.Empty())
+			{
+				oldest = std::min(oldest, SlotAt(lane.fifo.Front()).enqueued);
+			}
+			for (const DeadlineEntry& entry : lane.deadlines)
+			{
+				oldest = std::min(oldest, SlotAt(entry.index).enqueued);
+			}
+		}
+		for (const DeferredEntry& deferred : m_deferred)
+		{
+			oldest = std::min(oldest, SlotAt(deferred.entry.index).enqueued);
+		}
+		stats.oldestPendingAge = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - oldest);
+		return stats;
+	}
+
+private:
+	using DestroyFunction = void(*)(void* event, AllocationTracker* tracker);
+	using EqualFunction = bool(*)(const void* left, const void* right);
+
+	static constexpr std::uint32_t NoSlot = ~std::uint32_t{ 0 };
+
+	struct Slot
+	{
+		alignas(std::max_align_t) unsigned char storage[InlineSize];
+		void* event = nullptr;               ///< Points into storage or to the separate allocation.
+		DispatchFunction dispatch = nullptr;
+		DestroyFunction destroy = nullptr;
+		Clock::time_point enqueued;
+		Clock::time_point deadline;
+		std::uint64_t sequence = 0;          ///< Enqueue order over all lanes; a dispatch only handles events older than itself.
+		QueueSlotState state;                ///< Referenced by the QueuedEvent handles; slots never move.
+		EqualFunction equal = nullptr;       ///< Set while a deduplicated event is pending in the slot.
+		std::size_t hash = 0;                ///< Hash of a deduplicated event.
+#if SIGNALBUS_QUEUE_LATENCY
+		std::uint32_t typeIndex = 0;         ///< QueuedTypeIndex of the event, selects its latency histogram.
+		std::uint64_t enqueuedTicks = 0;     ///< ReadTimestamp at enqueue.
+#endif
+	};
+
+	/// @brief Entry of the open addressing set of pending deduplicated events.
+	struct PendingEntry
+	{
+		std::size_t hash = 0;
+		std::uint32_t slot = NoSlot;
+	};
+
+	static constexpr std::uint32_t ChunkSize = 64;
+
+	/// @brief Growable ring buffer of slot indices.
+	class SlotRing
+	{
+	public:
+		explicit SlotRing(AllocationTracker* tracker)
+			: m_indices(TrackingAllocator<std::uint32_t>(tracker, AllocationCategory::Queues)) {}
+
+		SlotRing(SlotRing&& other) noexcept
+			: m_indices(std::move(other.m_indices)), m_head(other.m_head), m_count(other.m_count)
+		{
+			other.m_head = 0;
+			other.m_count = 0;
+		}
+
+		bool Empty() const
+		{
+			return m_count == 0;
+		}
+
+		std::size_t Size() const
+		{
+			return m_count;
+		}
+
+		std::uint32_t Front() const
+		{
+			return m_indices[m_head];
+		}
+
+		void PushBack(std::uint32_t index)
+		{
+			if (m_count == m_indices.size())
+			{
+				Grow();
+			}
+			m_indices[(m_head + m_count) & (m_indices.size() - 1)] = index;
+			++m_count;
+		}
+
+		std::uint32_t PopFront()
+		{
+			const std::uint32_t index = m_indices[m_head];
+			m_head = (m_head + 1) & (m_indices.size() - 1);
+			--m_count;
+			return index;
+		}
+
+		void Swap(SlotRing& other) noexcept
+		{
+			m_indices.swap(other.m_indices);
+			std::swap(m_head, other.m_head);
+			std::swap(m_count, other.m_count);
+		}
+
+	private:
+		/// @brief Doubles the capacity (kept a power of two), unwrapping the queued indices.
+		void Grow()
+		{
+			std::vector<std::uint32_t, TrackingAllocator<std::uint32_t>> grown(m_indices.get_allocator());
+			grown.resize(m_indices.empty() ? 16 : m_indices.size() * 2);
+			for (std::size_t i = 0; i < m_count; ++i)
+			{
+				grown[i] = m_indices[(m_head + i) & (m_indices.size() - 1)];
+			}
+			m_indices.swap(grown);
+			m_head = 0;
+		}
+
+		std::vector<std::uint32_t, TrackingAllocator<std::uint32_t>> m_indices;
+		std::size_t m_head = 0;
+		std::size_t m_count = 0;
+	};
+
+	struct SlotChunk
+	{
+		Slot slots[ChunkSize];
+	};
+
+	/// @brief Position of an event with a deadline in the EDF heap of its lane.
+	struct DeadlineEntry
+	{
+		Clock::time_point deadline;
+		std::uint64_t sequence; ///< Keeps events with the same deadline in enqueue order.
+		std::uint32_t index;
+	};
+
+	/// @brief A deadline event enqueued during a dispatch, kept out of its heap until the dispatch ends.
+	struct DeferredEntry
+	{
+		DeadlineEntry entry;
+		std::size_t priority;
+	};
+
+	/// @brief Heap order of the deadline entries: the earliest deadline ends up on top.
+	static bool LaterDeadline(const DeadlineEntry& left, const DeadlineEntry& right)
+	{
+		return left.deadline != right.deadline ? left.deadline > right.deadline : left.sequence > right.sequence;
+	}
+
+	/// @brief Queued events of one priority.
+	struct Lane
+	{
+		explicit Lane(AllocationTracker* tracker)
+			: fifo(tracker), deadlines(TrackingAllocator<DeadlineEntry>(tracker, AllocationCategory::Queues)) {}
+
+		void Swap(Lane& other) noexcept
+		{
+			fifo.Swap(other.fifo);
+			deadlines.swap(other.deadlines);
+		}
+
+		SlotRing fifo;                                                                 ///< Events without a deadline, oldest first.
+		std::vector<DeadlineEntry, TrackingAllocator<DeadlineEntry>> deadlines;        ///< Events with a deadline, as a heap.
+	};
+
+	/// @brief The loop of Dispatch: handles events with a sequence below end until the budget is used up.
+	/// Newer deadline events surfacing on the way are parked in m_deferred; Dispatch puts them back.
+	std::size_t DispatchUntil(void* target, const DispatchBudget& budget, Clock::time_point start, std::uint64_t end)
+	{
+		std::size_t dispatched = 0;
+		while (dispatched < budget.maxEvents)
+		{
+			const Clock::time_point now = Clock::now();
+			if (dispatched > 0 && now - start >= budget.maxTime) break;
+
+			const std::uint32_t index = PopNext(end);
+			if (index == NoSlot) break;
+
+			Slot& slot = SlotAt(index);
+			if (slot.state.cancelled)
+			{
+				++m_stats.cancelled;
+				Release(index);
+				continue;
+			}
+			if (slot.deadline < now)
+			{
+				++m_stats.expired;
+				Release(index);
+				continue;
+			}
+
+			++slot.state.generation; // The event is in flight, its handles can no longer cancel it
+			RecordDispatchAge(now - slot.enqueued);
+#if SIGNALBUS_QUEUE_LATENCY
+			m_latency[slot.typeIndex].Record(ReadTimestamp() - slot.enqueuedTicks);
+#endif
+			try
+			{
+				slot.dispatch(target, slot.event);
+			}
+			catch (...)
+			{
+				Release(index);
+				throw;
+			}
+			Release(index);
+			++dispatched;
+		}
+		return dispatched;
+	}
+
+	/// @brief Removes the next event to dispatch among those enqueued before the given sequence.
+	/// From here on it no longer counts as a pending duplicate.
+	/// @return The slot of the event, or NoSlot if there is none.
+	std::uint32_t PopNext(std::uint64_t end)
+	{
+		const std::uint32_t index = PopLane(end);
+		if (index == NoSlot) return NoSlot;
+
+		const Slot& slot = SlotAt(index);
+		if (slot.equal != nullptr)
+		{
+			ErasePending(slot.hash, index);
+		}
+		return index;
+	}
+
+	/// @brief Removes the next event from the highest lane holding an event older than end, by deadline, then by age.
+	/// Newer events on top of a deadline heap are parked in m_deferred; newer events in a FIFO are all behind the older ones.
+	std::uint32_t PopLane(std::uint64_t end)
+	{
+		for (std::size_t priority = 0; priority < m_lanes.size(); ++priority)
+		{
+			Lane& lane = m_lanes[priority];
+			while (!lane.deadlines.empty())
+			{
+				std::pop_heap(lane.deadlines.begin(), lane.deadlines.end(), &LaterDeadline);
+				const DeadlineEntry entry = lane.deadlines.back();
+				lane.deadlines.pop_back();
+				if (entry.sequence < end)
+				{
+					--m_size;
+					return entry.index;
+				}
+
+				m_deferred.push_back(DeferredEntry{ entry, priority }); // Capacity reserved by Push
+			}
+			if (!lane.fifo.Empty() && SlotAt(lane.fifo.Front()).sequence < end)
+			{
+				--m_size;
+				return lane.fifo.PopFront();
+			}
+		}
+		return NoSlot;
+	}
+
+	/// @brief Makes room for count elements, growing geometrically so repeated calls stay amortized constant.
+	template <typename Vector>
+	static void Reserve(Vector& vector, std::size_t count)
+	{
+		if (count > vector.capacity())
+		{
+			vector.reserve(std::max(count, vector.capacity() * 2));
+		}
+	}
+
+	/// @brief Returns the deadline events parked by PopLane to their heaps.
+	void RestoreDeferred() noexcept
+	{
+		for (const DeferredEntry& deferred : m_deferred)
+		{
+			Lane& lane = m_lanes[deferred.priority];
+			lane.deadlines.push_back(deferred.entry); // Capacity reserved by Push
+			std::push_heap(lane.deadlines.begin(), lane.deadlines.end(), &LaterDeadline);
+		}
+		m_deferred.clear();
+	}
+
+	template <typename Event>
+	static bool EqualStub(const void* left, const void* right)
+	{
+		return EventDedupOf<Event>::Equal(*static_cast<const Event*>(left), *static_cast<const Event*>(right));
+	}
+
+	/// @brief Looks for a pending, not cancelled event equal to the given one, using linear probing.
+	/// @return Its slot, or NoSlot.
+	std::uint32_t FindPending(std::size_t hash, EqualFunction equal, const void* event) const
+	{
+		if (m_pending.empty()) return NoSlot;
+
+		const std::size_t mask = m_pending.size() - 1;
+		for (std::size_t i = hash & mask; m_pending[i].slot != NoSlot; i = (i + 1) & mask)
+		{
+			if (m_pending[i].hash != hash) continue;
+
+			const Slot& slot = SlotAt(m_pending[i].slot);
+			if (slot.equal == equal && !slot.state.cancelled && equal(slot.event, event)) return m_pending[i].slot;
+		}
+		return NoSlot;
+	}
+
+	/// @brief Grows the set so one more entry keeps it at most half full.
+	void ReservePending()
+	{
+		if ((m_pendingCount + 1) * 2 <= m_pending.size()) return;
+
+		std::vector<PendingEntry, TrackingAllocator<PendingEntry>> grown(m_pending.get_allocator());
+		grown.resize(m_pending.empty() ? 16 : m_pending.size() * 2);
+		m_pending.swap(grown);
+		m_pendingCount = 0;
+		for (const PendingEntry& entry : grown)
+		{
+			if (entry.slot != NoSlot)
+			{
+				InsertPending(entry.hash, entry.slot);
+			}
+		}
+	}
+
+	void InsertPending(std::size_t hash, std::uint32_t index)
+	{
+		const std::size_t mask = m_pending.size() - 1;
+		std::size_t i = hash & mask;
+		while (m_pending[i].slot != NoSlot)
+		{
+			i = (i + 1) & mask;
+		}
+		m_pending[i] = PendingEntry{ hash, index };
+		++m_pendingCount;
+	}
+
+	/// @brief Removes an entry, shifting later entries of its probe sequence back instead of leaving a tombstone.
+	void ErasePending(std::size_t hash, std::uint32_t index)
+	{
+		const std::size_t mask = m_pending.size() - 1;
+		std::size_t hole = hash & mask;
+		while (m_pending[hole].slot != index)
+		{
+			hole = (hole + 1) & mask;
+		}
+
+		for (std::size_t next = (hole + 1) & mask; m_pending[next].slot != NoSlot; next = (next + 1) & mask)
+		{
+			// An entry may fill the hole only if its home position is not between the hole and itself
+			const std::size_t home = m_pending[next].hash & mask;
+			const bool homeInBetween = hole <= next ? (hole < home && home <= next) : (hole < home || home <= next);
+			if (!homeInBetween)
+			{
+				m_pending[hole] = m_pending[next];
+				hole = next;
+			}
+		}
+		m_pending[hole] = PendingEntry{};
+		--m_pendingCount;
+	}
+
+	template <typename Event>
+	void Store(Slot& slot, const Event& event)
+	{
+		if constexpr (sizeof(Event) <= InlineSize && alignof(Event) <= alignof(std::max_align_t))
+		{
+			slot.event = new (slot.storage) Event(event);
+			slot.destroy = &DestroyInline<Event>;
+		}
+		else
+		{
+			TrackingAllocator<Event> allocator(m_tracker, AllocationCategory::Queues);
+			Event* stored = allocator.allocate(1);
+			try
+			{
+				new (stored) Event(event);
+			}
+			catch (...)
+			{
+				allocator.deallocate(stored, 1);
+				throw;
+			}
+			slot.event = stored;
+			slot.destroy = &DestroyAllocated<Event>;
+		}
+	}
+
+	template <typename Event>
+	static void DestroyInline(void* event, AllocationTracker* /* unused */)
+	{
+		static_cast<Event*>(event)->~Event();
+	}
+
+	template <typename Event>
+	static void DestroyAllocated(void* event, AllocationTracker* tracker)
+	{
+		auto* stored = static_cast<Event*>(event);
+		stored->~Event();
+		TrackingAllocator<Event>(tracker, AllocationCategory::Queues).deallocate(stored, 1);
+	}
+
+	Slot& SlotAt(std::uint32_t index)
+	{
+		return m_chunks[index / ChunkSize]->slots[index % ChunkSize];
+	}
+
+	const Slot& SlotAt(std::uint32_t index) const
+	{
+		return m_chunks[index / ChunkSize]->slots[index % ChunkSize];
+	}
+
+	/// @brief Takes a free slot, adding a chunk of slots if none is left.
+	std::uint32_t AcquireSlot()
+	{
+		if (m_free.empty())
+		{
+			TrackingAllocator<SlotChunk> allocator(m_tracker, AllocationCategory::Queues);
+			SlotChunk* chunk = allocator.allocate(1);
+			new (chunk) SlotChunk();
+			try
+			{
+				m_chunks.push_back(chunk);
+			}
+			catch (...)
+			{
+				chunk->~SlotChunk();
+				allocator.deallocate(chunk, 1);
+				throw;
+			}
+
+			const auto first = static_cast<std::uint32_t>((m_chunks.size() - 1) * ChunkSize);
+			// Room for every slot, so returning a slot to the free list never allocates
+			m_free.reserve(m_chunks.size() * ChunkSize);
+			for (std::uint32_t i = ChunkSize; i > 0; --i)
+			{
+				m_free.push_back(first + i - 1);
+			}
+		}
+
+		const std::uint32_t index = m_free.back();
+		m_free.pop_back();
+		return index;
+	}
+
+	/// @brief Destroys the event of a slot and returns the slot to the free list.
+	void Release(std::uint32_t index)
+	{
+		Slot& slot = SlotAt(index);
+		slot.destroy(slot.event, m_tracker);
+		slot.event = nullptr;
+		++slot.state.generation;
+		slot.state.cancelled = false;
+		m_free.push_back(index);
+	}
+
+	void RecordDispatchAge(Clock::duration age)
+	{
+		const auto nanoseconds = std::chrono::duration_cast<std::chrono::nanoseconds>(age);
+		++m_stats.dispatched;
+		m_stats.totalDispatchAge += nanoseconds;
+		if (nanoseconds > m_stats.maxDispatchAge)
+		{
+			m_stats.maxDispatchAge = nanoseconds;
+		}
+	}
+
+	AllocationTracker* m_tracker;
+	std::vector<SlotChunk*, TrackingAllocator<SlotChunk*>> m_chunks;
+	std::vector<std::uint32_t, TrackingAllocator<std::uint32_t>> m_free;   ///< Indices of unused slots.
+	std::array<Lane, static_cast<std::size_t>(QueuePriority::Count)> m_lanes;
+	std::size_t m_size = 0;                                                ///< Queued events over all lanes, parked ones included.
+	std::uint64_t m_nextSequence = 0;
+	std::vector<DeferredEntry, TrackingAllocator<DeferredEntry>> m_deferred; ///< Deadline events parked during a dispatch.
+	std::vector<PendingEntry, TrackingAllocator<PendingEntry>> m_pending;  ///< Pending deduplicated events, open addressing.
+	std::size_t m_pendingCount = 0;
+	QueueStats m_stats;                                                    ///< Dispatch metrics; pending fields are filled in by Stats.
+#if SIGNALBUS_QUEUE_LATENCY
+	std::vector<LatencyHistogram, TrackingAllocator<LatencyHistogram>> m_latency; ///< Indexed by QueuedTypeIndex.
+#endif
+};
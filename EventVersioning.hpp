@@ -0,0 +1,199 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+#include "SignalBus.hpp"
+
+/// @brief Version of an event type, taken from a static EventVersion member if the type declares one, otherwise 1.
+/// @tparam T The type of the event.
+template <typename T, typename = void>
+struct EventVersionOf : std::integral_constant<std::uint16_t, 1> { };
+
+template <typename T>
+struct EventVersionOf<T, std::void_t<decltype(T::EventVersion)>> : std::integral_constant<std::uint16_t, T::EventVersion> { };
+
+/// @brief Header written in front of every event payload that leaves the process.
+/// Events are identified by a stable EventTypeId the event type declares, since std::type_index differs between builds.
+struct EventRecordHeader
+{
+	std::uint32_t typeId = 0;  ///< The EventTypeId of the recorded event type.
+	std::uint16_t version = 0; ///< The EventVersion the payload was written with.
+	std::uint16_t reserved = 0;
+	std::uint32_t size = 0;    ///< Size of the payload following the header, in bytes.
+};
+
+/// @brief Outcome of EventSchemaRegistry::Replay.
+enum class ReplayResult
+{
+	Delivered,     ///< The event was emitted on the bus.
+	UnknownType,   ///< The type id was never registered.
+	NoUpgradePath, ///< The payload has a version that can not be upgraded to the current one.
+	SizeMismatch   ///< The payload size does not match the size of its version.
+};
+
+/// @brief Appends an event, prefixed with its EventRecordHeader, to a byte stream.
+/// @tparam Event A trivially copyable event type declaring a static EventTypeId (and optionally EventVersion).
+/// @param event The event to encode.
+/// @param out The stream to append to.
+template <typename Event>
+void EncodeEvent(const Event& event, std::vector<std::byte>& out)
+{
+	static_assert(std::is_trivially_copyable_v<Event>, "Only trivially copyable events can leave the process");
+
+	EventRecordHeader header;
+	header.typeId = Event::EventTypeId;
+	header.version = EventVersionOf<Event>::value;
+	header.size = sizeof(Event);
+
+	const std::size_t offset = out.size();
+	out.resize(offset + sizeof(header) + sizeof(Event));
+	std::memcpy(out.data() + offset, &header, sizeof(header));
+	std::memcpy(out.data() + offset + sizeof(header), &event, sizeof(Event));
+}
+
+/// @brief Registry of recorded event types and of the functions upgrading their older versions.
+/// Payloads are kept as recorded; upgrades run lazily and only when Replay meets a payload older
+/// than the current version, so replaying current-version events costs a version compare and a copy.
+class EventSchemaRegistry
+{
+public:
+	/// @brief Makes an event type replayable in its current version.
+	/// @tparam Event A trivially copyable, default constructible event type declaring a static EventTypeId.
+	template <typename Event>
+	void Register()
+	{
+		static_assert(std::is_trivially_copyable_v<Event> && std::is_default_constructible_v<Event>,
+			"Replayed events have to be trivially copyable and default constructible");
+
+		Entry& entry = m_entries[Event::EventTypeId];
+		entry.currentVersion = EventVersionOf<Event>::value;
+		entry.currentSize = sizeof(Event);
+		entry.emit = &EmitStub<Event>;
+	}
+
+	/// @brief Registers the upgrade of one older version of an event type to a newer one.
+	/// Upgrades are chained until the current version registered for the type id is reached.
+	/// @tparam Event The current event type, identifying the type id.
+	/// @tparam Old The layout of the older version, declaring its EventVersion.
+	/// @tparam New The layout of the version Old is upgraded to, declaring a higher EventVersion.
+	/// @tparam Upgrade The function converting Old into New.
+	template <typename Event, typename Old, typename New, New(*Upgrade)(const Old&)>
+	void RegisterUpgrade()
+	{
+		static_assert(std::is_trivially_copyable_v<Old> && std::is_trivially_copyable_v<New>,
+			"Versioned layouts have to be trivially copyable");
+		static_assert(EventVersionOf<Old>::value < EventVersionOf<New>::value, "Upgrades have to increase the version");
+
+		m_entries[Event::EventTypeId].upgrades[EventVersionOf<Old>::value] =
+			UpgradeStep{ EventVersionOf<New>::value, sizeof(Old), &UpgradeStub<Old, New, Upgrade> };
+	}
+
+	/// @brief Decodes one recorded event, upgrading it if needed, and emits it on the bus.
+	/// @param bus The bus to emit on.
+	/// @param header The header of the record.
+	/// @param payload The payload following the header. Does not have to be aligned.
+	/// @return Whether the event was delivered and why not.
+	ReplayResult Replay(SignalBus& bus, const EventRecordHeader& header, const void* payload) const
+	{
+		const auto it = m_entries.find(header.typeId);
+		if (it == m_entries.end() || it->second.emit == nullptr) return ReplayResult::UnknownType;
+
+		const Entry& entry = it->second;
+		if (header.version == entry.currentVersion)
+		{
+			if (header.size != entry.currentSize) return ReplayResult::SizeMismatch;
+			entry.emit(bus, payload);
+			return ReplayResult::Delivered;
+		}
+
+		// Slow path, only taken for payloads recorded with an older version
+		std::vector<std::byte> current(static_cast<const std::byte*>(payload), static_cast<const std::byte*>(payload) + header.size);
+		std::vector<std::byte> next;
+		std::uint16_t version = header.version;
+		while (version != entry.currentVersion)
+		{
+			const auto step = entry.upgrades.find(version);
+			if (step == entry.upgrades.end()) return ReplayResult::NoUpgradePath;
+			if (current.size() != step->second.fromSize) return ReplayResult::SizeMismatch;
+
+			step->second.upgrade(current.data(), next);
+			current.swap(next);
+			version = step->second.toVersion;
+		}
+
+		if (current.size() != entry.currentSize) return ReplayResult::SizeMismatch;
+		entry.emit(bus, current.data());
+		return ReplayResult::Delivered;
+	}
+
+	/// @brief Replays every record of a byte stream written with EncodeEvent.
+	/// @param bus The bus to emit on.
+	/// @param data The stream.
+	/// @param size The size of the stream, in bytes.
+	/// @return The number of delivered events.
+	std::size_t ReplayStream(SignalBus& bus, const void* data, std::size_t size) const
+	{
+		const auto* cursor = static_cast<const std::byte*>(data);
+		const auto* end = cursor + size;
+		std::size_t delivered = 0;
+
+		while (static_cast<std::size_t>(end - cursor) >= sizeof(EventRecordHeader))
+		{
+			EventRecordHeader header;
+			std::memcpy(&header, cursor, sizeof(header));
+			cursor += sizeof(header);
+			if (static_cast<std::size_t>(end - cursor) < header.size) break; // Truncated record
+
+			if (Replay(bus, header, cursor) == ReplayResult::Delivered)
+			{
+				++delivered;
+			}
+			cursor += header.size;
+		}
+		return delivered;
+	}
+
+private:
+	using EmitFunction = void(*)(SignalBus&, const void*);
+	using UpgradeFunction = void(*)(const void*, std::vector<std::byte>&);
+
+	struct UpgradeStep
+	{
+		std::uint16_t toVersion = 0;
+		std::size_t fromSize = 0;
+		UpgradeFunction upgrade = nullptr;
+	};
+
+	struct Entry
+	{
+		std::uint16_t currentVersion = 0;
+		std::size_t currentSize = 0;
+		EmitFunction emit = nullptr;
+		std::unordered_map<std::uint16_t, UpgradeStep> upgrades; ///< Keyed by the version the step upgrades from.
+	};
+
+	template <typename Event>
+	static void EmitStub(SignalBus& bus, const void* payload)
+	{
+		Event event;
+		std::memcpy(&event, payload, sizeof(Event));
+		bus.Emit<Event>(event);
+	}
+
+	template <typename Old, typename New, New(*Upgrade)(const Old&)>
+	static void UpgradeStub(const void* payload, std::vector<std::byte>& out)
+	{
+		Old old;
+		std::memcpy(&old, payload, sizeof(Old));
+		const New upgraded = (*Upgrade)(old);
+
+		out.resize(sizeof(New));
+		std::memcpy(out.data(), &upgraded, sizeof(New));
+	}
+
+	std::unordered_map<std::uint32_t, Entry> m_entries;
+};
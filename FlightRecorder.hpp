@@ -0,0 +1,312 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <mutex>
+#include <new>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <type_traits>
+#include <typeinfo>
+#include <utility>
+
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#if defined(__linux__)
+#include <sys/syscall.h>
+#endif
+#endif
+
+#include "Timestamp.hpp"
+
+/// @brief Id of an event type in flight recordings: the EventTypeId the type declares for persistence
+/// (see EventVersioning.hpp), otherwise a hash of its compiler-specific name. Type names are stored
+/// in the recording as well, so the decoder can show them either way.
+/// @tparam T The type of the event.
+template <typename T, typename = void>
+struct FlightRecorderTypeIdOf
+{
+	static std::uint32_t Get()
+	{
+		// FNV-1a, folded to 32 bits
+		std::uint64_t hash = 14695981039346656037ull;
+		for (const char* name = typeid(T).name(); *name != '\0'; ++name)
+		{
+			hash = (hash ^ static_cast<unsigned char>(*name)) * 1099511628211ull;
+		}
+		return static_cast<std::uint32_t>(hash ^ (hash >> 32));
+	}
+};
+
+template <typename T>
+struct FlightRecorderTypeIdOf<T, std::void_t<decltype(T::EventTypeId)>>
+{
+	static std::uint32_t Get()
+	{
+		return static_cast<std::uint32_t>(T::EventTypeId);
+	}
+};
+
+/// @brief Start of a flight recording file. All fields are fixed size, so the decoder can read
+/// recordings of other builds of the same platform.
+struct FlightRecordingHeader
+{
+	static constexpr char Magic[8] = { 'S', 'B', 'F', 'L', 'R', 'E', 'C', '\0' };
+	static constexpr std::uint32_t CurrentVersion = 1;
+
+	char magic[8];
+	std::uint32_t version;
+	std::uint32_t recordSize;          ///< Bytes per record, FlightRecord included.
+	std::uint64_t recordCount;         ///< Number of records in the ring, a power of two.
+	std::uint32_t payloadBytes;        ///< Bytes of each event kept after its FlightRecord.
+	std::uint32_t typeCapacity;        ///< Number of FlightRecordingType entries following the header.
+	double ticksPerNanosecond;         ///< Converts record timestamps to time.
+	std::uint64_t anchorTicks;         ///< ReadTimestamp when the recording was opened...
+	std::int64_t anchorUnixNanoseconds;///< ...and the wall clock time at that moment.
+	alignas(64) std::atomic<std::uint64_t> next; ///< Number of records ever started; the ring position is next % recordCount.
+	alignas(64) std::atomic<std::uint32_t> typeCount;
+};
+
+/// @brief Name of a recorded event type.
+struct FlightRecordingType
+{
+	std::uint32_t id;
+	char name[60]; ///< typeid name, truncated and null terminated.
+};
+
+/// @brief One recorded emit. The first payloadBytes bytes of the event follow it.
+/// begin and end both hold the record's sequence number plus one; they differ while a record is being
+/// written, or if a crash interrupted the write.
+struct FlightRecord
+{
+	std::atomic<std::uint64_t> begin;
+	std::uint32_t typeId;
+	std::uint32_t eventSize; ///< sizeof the event; only min(eventSize, payloadBytes) bytes are kept.
+	std::uint64_t timestamp; ///< ReadTimestamp ticks.
+	std::uint64_t thread;    ///< OS thread id where available, otherwise a hash of std::thread::id.
+	std::atomic<std::uint64_t> end;
+};
+
+/// @brief Always-on recorder of the most recent emits of a SignalBus, kept in a memory-mapped file.
+/// The file survives a crash of the process and can be decoded with tools/flight_decode.cpp.
+/// Recording is lock-free: one atomic increment, a timestamp and a copy of the first bytes of the event.
+/// Attach it with SignalBus::SetFlightRecorder; one recorder may be shared by several buses and threads.
+class FlightRecorder
+{
+public:
+	/// @brief Creates (or overwrites) the recording file and maps it.
+	/// @param path The file to record into.
+	/// @param recordCount The number of most recent emits to keep, rounded up to a power of two.
+	/// @param payloadBytes The number of leading bytes of each event to keep.
+	/// @throws std::system_error if the file can not be created or mapped.
+	explicit FlightRecorder(const std::string& path, std::size_t recordCount = 4096, std::size_t payloadBytes = 24)
+	{
+		std::size_t count = 2;
+		while (count < recordCount)
+		{
+			count *= 2;
+		}
+		m_mask = count - 1;
+		m_recordSize = (sizeof(FlightRecord) + payloadBytes + 7) / 8 * 8;
+		m_payloadBytes = payloadBytes;
+		m_recordsOffset = (sizeof(FlightRecordingHeader) + TypeCapacity * sizeof(FlightRecordingType) + 63) / 64 * 64;
+		m_size = m_recordsOffset + count * m_recordSize;
+
+		Map(path);
+
+		m_header = new (m_mapping) FlightRecordingHeader();
+		std::memcpy(m_header->magic, FlightRecordingHeader::Magic, sizeof(m_header->magic));
+		m_header->version = FlightRecordingHeader::CurrentVersion;
+		m_header->recordSize = static_cast<std::uint32_t>(m_recordSize);
+		m_header->recordCount = count;
+		m_header->payloadBytes = static_cast<std::uint32_t>(payloadBytes);
+		m_header->typeCapacity = TypeCapacity;
+		m_header->ticksPerNanosecond = TimestampTicksPerNanosecond();
+		m_header->anchorTicks = ReadTimestamp();
+		m_header->anchorUnixNanoseconds = std::chrono::duration_cast<std::chrono::nanoseconds>(
+			std::chrono::system_clock::now().time_since_epoch()).count();
+		m_header->next.store(0, std::memory_order_relaxed);
+		m_header->typeCount.store(0, std::memory_order_relaxed);
+
+		m_types = reinterpret_cast<FlightRecordingType*>(m_mapping + sizeof(FlightRecordingHeader));
+		m_records = m_mapping + m_recordsOffset;
+	}
+
+	FlightRecorder(const FlightRecorder&) = delete;
+	auto operator=(const FlightRecorder&)->FlightRecorder & = delete;
+
+	~FlightRecorder()
+	{
+		Unmap();
+	}
+
+	/// @brief Records one emit.
+	/// @tparam Event The type of the event.
+	/// @param event The emitted event.
+	template <typename Event>
+	void Record(const Event& event)
+	{
+		const std::uint32_t typeId = TypeId<Event>();
+
+		const std::uint64_t sequence = m_header->next.fetch_add(1, std::memory_order_relaxed);
+		auto* record = reinterpret_cast<FlightRecord*>(m_records + (sequence & m_mask) * m_recordSize);
+		record->begin.store(sequence + 1, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_release);
+
+		record->typeId = typeId;
+		record->eventSize = static_cast<std::uint32_t>(sizeof(Event));
+		record->timestamp = ReadTimestamp();
+		record->thread = ThreadId();
+		std::memcpy(reinterpret_cast<unsigned char*>(record + 1), reinterpret_cast<const unsigned char*>(std::addressof(event)),
+			std::min(sizeof(Event), m_payloadBytes));
+
+		record->end.store(sequence + 1, std::memory_order_release);
+	}
+
+	/// @brief Returns the number of emits recorded so far, including those already overwritten.
+	std::uint64_t Recorded() const
+	{
+		return m_header->next.load(std::memory_order_relaxed);
+	}
+
+private:
+	static constexpr std::uint32_t TypeCapacity = 256;
+
+	static constexpr std::size_t RegisteredCacheSize = 4;
+
+	/// @brief Returns the id of an event type, writing its name into the recording the first time it is recorded.
+	/// Every type remembers the serials of the last few recorders it was registered in, so a new recorder reusing
+	/// the address of a destroyed one still gets the name, and a few recorders used alternately stay lock-free.
+	template <typename Event>
+	std::uint32_t TypeId()
+	{
+		static const std::uint32_t id = FlightRecorderTypeIdOf<Event>::Get();
+		static std::atomic<std::uint64_t> registeredIn[RegisteredCacheSize] = {};
+		static std::atomic<std::uint32_t> nextCacheSlot{ 0 };
+		for (const auto& serial : registeredIn)
+		{
+			if (serial.load(std::memory_order_acquire) == m_serial) return id;
+		}
+
+		RegisterType(id, typeid(Event).name());
+		registeredIn[nextCacheSlot.fetch_add(1, std::memory_order_relaxed) % RegisteredCacheSize].store(m_serial, std::memory_order_release);
+		return id;
+	}
+
+	/// @brief Serial number of a recorder, never 0 and never reused, so a zero-initialized cache matches no recorder.
+	static std::uint64_t NextSerial()
+	{
+		static std::atomic<std::uint64_t> serial{ 0 };
+		return serial.fetch_add(1, std::memory_order_relaxed) + 1;
+	}
+
+	void RegisterType(std::uint32_t id, const char* name)
+	{
+		std::lock_guard<std::mutex> lock(m_typeMutex);
+		const std::uint32_t count = m_header->typeCount.load(std::memory_order_relaxed);
+		for (std::uint32_t i = 0; i < count; ++i)
+		{
+			if (m_types[i].id == id) return;
+		}
+		if (count == TypeCapacity) return; // Records still carry the id
+
+		FlightRecordingType& type = m_types[count];
+		type.id = id;
+		std::strncpy(type.name, name, sizeof(type.name) - 1);
+		type.name[sizeof(type.name) - 1] = '\0';
+		m_header->typeCount.store(count + 1, std::memory_order_release);
+	}
+
+	static std::uint64_t ThreadId()
+	{
+		static thread_local const std::uint64_t id = []
+		{
+#if defined(_WIN32)
+			return static_cast<std::uint64_t>(GetCurrentThreadId());
+#elif defined(__linux__)
+			return static_cast<std::uint64_t>(syscall(SYS_gettid));
+#else
+			return static_cast<std::uint64_t>(std::hash<std::thread::id>{}(std::this_thread::get_id()));
+#endif
+		}();
+		return id;
+	}
+
+	void Map(const std::string& path)
+	{
+#if defined(_WIN32)
+		m_file = CreateFileA(path.c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ, nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+		if (m_file == INVALID_HANDLE_VALUE) ThrowLastError("Can not create flight recording");
+
+		const auto size = static_cast<std::uint64_t>(m_size);
+		m_fileMapping = CreateFileMappingA(m_file, nullptr, PAGE_READWRITE, static_cast<DWORD>(size >> 32), static_cast<DWORD>(size), nullptr);
+		if (m_fileMapping == nullptr) ThrowLastError("Can not map flight recording");
+
+		m_mapping = static_cast<unsigned char*>(MapViewOfFile(m_fileMapping, FILE_MAP_ALL_ACCESS, 0, 0, m_size));
+		if (m_mapping == nullptr) ThrowLastError("Can not map flight recording");
+#else
+		m_file = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+		if (m_file < 0) ThrowLastError("Can not create flight recording");
+		if (::ftruncate(m_file, static_cast<off_t>(m_size)) != 0) ThrowLastError("Can not size flight recording");
+
+		void* mapping = ::mmap(nullptr, m_size, PROT_READ | PROT_WRITE, MAP_SHARED, m_file, 0);
+		if (mapping == MAP_FAILED) ThrowLastError("Can not map flight recording");
+		m_mapping = static_cast<unsigned char*>(mapping);
+#endif
+	}
+
+	void Unmap() noexcept
+	{
+#if defined(_WIN32)
+		if (m_mapping != nullptr) UnmapViewOfFile(m_mapping);
+		if (m_fileMapping != nullptr) CloseHandle(m_fileMapping);
+		if (m_file != INVALID_HANDLE_VALUE) CloseHandle(m_file);
+#else
+		if (m_mapping != nullptr) ::munmap(m_mapping, m_size);
+		if (m_file >= 0) ::close(m_file);
+#endif
+	}
+
+	[[noreturn]] void ThrowLastError(const char* what)
+	{
+#if defined(_WIN32)
+		const std::error_code error(static_cast<int>(GetLastError()), std::system_category());
+#else
+		const std::error_code error(errno, std::generic_category());
+#endif
+		Unmap();
+		throw std::system_error(error, what);
+	}
+
+#if defined(_WIN32)
+	HANDLE m_file = INVALID_HANDLE_VALUE;
+	HANDLE m_fileMapping = nullptr;
+#else
+	int m_file = -1;
+#endif
+	unsigned char* m_mapping = nullptr;
+	std::size_t m_size = 0;
+
+	FlightRecordingHeader* m_header = nullptr;
+	FlightRecordingType* m_types = nullptr;
+	unsigned char* m_records = nullptr;
+	std::size_t m_recordsOffset = 0;
+	std::size_t m_recordSize = 0;
+	std::size_t m_payloadBytes = 0;
+	std::uint64_t m_mask = 0;
+	std::uint64_t m_serial = NextSerial();
+	std::mutex m_typeMutex;
+};
@@ -0,0 +1,181 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include <typeinfo>
+
+#include "Timestamp.hpp"
+
+/// @brief Set to 1 to let every dispatching thread publish the handler it is currently running,
+/// which HandlerWatchdog observes. Costs a timestamp and a few relaxed stores per handler call.
+#ifndef SIGNALBUS_WATCHDOG
+#define SIGNALBUS_WATCHDOG 0
+#endif
+
+/// @brief What one thread is currently dispatching, published without locks for HandlerWatchdog.
+/// Records are allocated once per thread, linked into a global list and reused after the thread exits.
+class HandlerActivity
+{
+public:
+	/// @brief Consistent copy of a record, taken by the watchdog.
+	struct Snapshot
+	{
+		std::uint64_t startTicks = 0;            ///< ReadTimestamp when the handler started; 0 if idle.
+		const std::type_info* eventType = nullptr;
+		const void* instance = nullptr;          ///< The subscriber instance, nullptr for free functions.
+		const void* stub = nullptr;              ///< Identifies the bound function (Delegate::StubAddress).
+		std::thread::id thread;
+	};
+
+	/// @brief Returns the record of the calling thread, acquiring one on the thread's first dispatch.
+	static HandlerActivity& Current()
+	{
+		static thread_local Lease lease;
+		return *lease.activity;
+	}
+
+	/// @brief Returns the first record of the global list; follow Next for the others.
+	static HandlerActivity* First()
+	{
+		return Head().load(std::memory_order_acquire);
+	}
+
+	HandlerActivity* Next() const
+	{
+		return m_next;
+	}
+
+	/// @brief Reads the record from another thread. Retries while the owner is switching handlers.
+	/// @param out Receives the copy.
+	/// @return False if the record is idle or unused.
+	bool Read(Snapshot& out) const
+	{
+		if (!m_inUse.load(std::memory_order_acquire)) return false;
+
+		for (int attempt = 0; attempt < 4; ++attempt)
+		{
+			const std::uint32_t version = m_version.load(std::memory_order_acquire);
+			if ((version & 1) != 0) continue; // Being written
+
+			out.startTicks = m_startTicks.load(std::memory_order_relaxed);
+			out.eventType = m_eventType.load(std::memory_order_relaxed);
+			out.instance = m_instance.load(std::memory_order_relaxed);
+			out.stub = m_stub.load(std::memory_order_relaxed);
+			out.thread = m_thread.load(std::memory_order_relaxed);
+			std::atomic_thread_fence(std::memory_order_acquire);
+			if (m_version.load(std::memory_order_relaxed) == version) return out.startTicks != 0;
+		}
+		return false;
+	}
+
+private:
+	friend class HandlerScope;
+
+	/// @brief Holds the record of a thread and returns it to the pool when the thread exits.
+	struct Lease
+	{
+		Lease()
+			: activity(Acquire()) {}
+
+		~Lease()
+		{
+			activity->m_inUse.store(false, std::memory_order_release);
+		}
+
+		HandlerActivity* activity;
+	};
+
+	static std::atomic<HandlerActivity*>& Head()
+	{
+		static std::atomic<HandlerActivity*> head{ nullptr };
+		return head;
+	}
+
+	/// @brief Claims a record left by an exited thread, or links a new one into the list.
+	static HandlerActivity* Acquire()
+	{
+		for (HandlerActivity* activity = First(); activity != nullptr; activity = activity->m_next)
+		{
+			bool unused = false;
+			if (activity->m_inUse.compare_exchange_strong(unused, true, std::memory_order_acquire))
+			{
+				activity->m_thread.store(std::this_thread::get_id(), std::memory_order_relaxed);
+				return activity;
+			}
+		}
+
+		// Records are never freed, the watchdog may be reading them at any time
+		auto* activity = new HandlerActivity();
+		activity->m_inUse.store(true, std::memory_order_relaxed);
+		activity->m_thread.store(std::this_thread::get_id(), std::memory_order_relaxed);
+		activity->m_next = Head().load(std::memory_order_relaxed);
+		while (!Head().compare_exchange_weak(activity->m_next, activity, std::memory_order_release, std::memory_order_relaxed)) {}
+		return activity;
+	}
+
+	std::atomic<std::uint32_t> m_version{ 0 };  ///< Seqlock over the fields below; odd while they change.
+	std::atomic<std::uint64_t> m_startTicks{ 0 };
+	std::atomic<const std::type_info*> m_eventType{ nullptr };
+	std::atomic<const void*> m_instance{ nullptr };
+	std::atomic<const void*> m_stub{ nullptr };
+	std::atomic<bool> m_inUse{ false };
+	std::atomic<std::thread::id> m_thread{};
+	HandlerActivity* m_next = nullptr;      ///< Immutable once linked.
+};
+
+/// @brief Publishes a handler as running on the calling thread for the lifetime of the scope.
+/// Nested emits publish the inner handler and restore the outer one afterwards.
+class HandlerScope
+{
+public:
+	HandlerScope(const std::type_info& eventType, const void* instance, const void* stub) noexcept
+		: m_activity(HandlerActivity::Current()),
+		  m_previousStart(m_activity.m_startTicks.load(std::memory_order_relaxed)),
+		  m_previousType(m_activity.m_eventType.load(std::memory_order_relaxed)),
+		  m_previousInstance(m_activity.m_instance.load(std::memory_order_relaxed)),
+		  m_previousStub(m_activity.m_stub.load(std::memory_order_relaxed))
+	{
+		Publish(ReadTimestamp(), &eventType, instance, stub);
+	}
+
+	HandlerScope(const HandlerScope&) = delete;
+	auto operator=(const HandlerScope&)->HandlerScope & = delete;
+
+	~HandlerScope()
+	{
+		Publish(m_previousStart, m_previousType, m_previousInstance, m_previousStub);
+	}
+
+private:
+	/// @brief Writes the record under its seqlock, so a concurrent Read never mixes two handlers.
+	/// Only the owning thread writes, so the version needs no read-modify-write.
+	void Publish(std::uint64_t start, const std::type_info* eventType, const void* instance, const void* stub) noexcept
+	{
+		const std::uint32_t version = m_activity.m_version.load(std::memory_order_relaxed);
+		m_activity.m_version.store(version + 1, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_release);
+		m_activity.m_startTicks.store(start, std::memory_order_relaxed);
+		m_activity.m_eventType.store(eventType, std::memory_order_relaxed);
+		m_activity.m_instance.store(instance, std::memory_order_relaxed);
+		m_activity.m_stub.store(stub, std::memory_order_relaxed);
+		m_activity.m_version.store(version + 2, std::memory_order_release);
+	}
+
+	HandlerActivity& m_activity;
+	std::uint64_t m_previousStart;
+	const std::type_info* m_previousType;
+	const void* m_previousInstance;
+	const void* m_previousStub;
+};
+
+/// @brief Calls a subscriber, publishing it as the running handler when SIGNALBUS_WATCHDOG is enabled.
+/// @tparam Event The type of the event.
+/// @tparam Handler Delegate or CompactDelegate.
+template <typename Event, typename Handler>
+inline void InvokeHandler(const Handler& handler, const Event& event)
+{
+#if SIGNALBUS_WATCHDOG
+	HandlerScope scope(typeid(Event), handler.Instance(), handler.StubAddress());
+#endif
+	handler(event);
+}
@@ -0,0 +1,122 @@
+#pragma once
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <string_view>
+#include <thread>
+#include <typeinfo>
+#include <unordered_map>
+
+#include "Delegate.hpp"
+#include "HandlerActivity.hpp"
+#include "SubscriberName.hpp"
+
+/// @brief A handler that has been running for longer than the watchdog's budget.
+struct HandlerOverrun
+{
+	const std::type_info* eventType = nullptr; ///< The type of the event being handled.
+	const void* instance = nullptr;            ///< The subscriber instance, nullptr for free functions.
+	const void* stub = nullptr;                ///< The bound function's stub, see Delegate::StubAddress.
+	std::string_view name;                     ///< The bound function, e.g. "Player::OnDamage"; empty if unknown.
+	std::thread::id thread;                    ///< The dispatching thread.
+	std::chrono::nanoseconds elapsed{ 0 };     ///< How long the handler had been running when it was detected.
+};
+
+/// @brief Background thread that periodically looks at the handler every dispatching thread is running
+/// and reports handlers exceeding a time budget, once per handler call.
+/// Requires SIGNALBUS_WATCHDOG=1, otherwise dispatching threads publish nothing and nothing is reported.
+/// The emit path only writes to its own thread's record; the watchdog never blocks it.
+class HandlerWatchdog
+{
+public:
+	/// @brief Starts the watchdog thread.
+	/// @param budget The longest a single handler call may run.
+	/// @param report Called on the watchdog thread for every handler call exceeding the budget.
+	/// @param period How often the dispatching threads are checked; overruns are detected up to one period late.
+	HandlerWatchdog(std::chrono::nanoseconds budget, Delegate<void(const HandlerOverrun&)> report,
+		std::chrono::milliseconds period = std::chrono::milliseconds(10))
+		: m_budgetTicks(static_cast<std::uint64_t>(static_cast<double>(budget.count()) * TimestampTicksPerNanosecond())),
+		  m_report(report),
+		  m_period(period),
+		  m_thread([this] { Run(); })
+	{
+	}
+
+	HandlerWatchdog(const HandlerWatchdog&) = delete;
+	auto operator=(const HandlerWatchdog&)->HandlerWatchdog & = delete;
+
+	~HandlerWatchdog()
+	{
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_stopping = true;
+		}
+		m_wake.notify_all();
+		m_thread.join();
+	}
+
+	/// @brief Returns the number of overruns reported so far.
+	std::uint64_t Overruns() const
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		return m_overruns;
+	}
+
+private:
+	void Run()
+	{
+		std::unique_lock<std::mutex> lock(m_mutex);
+		while (!m_wake.wait_for(lock, m_period, [this] { return m_stopping; }))
+		{
+			lock.unlock();
+			Check();
+			lock.lock();
+		}
+	}
+
+	void Check()
+	{
+		HandlerActivity::Snapshot snapshot;
+		for (const HandlerActivity* activity = HandlerActivity::First(); activity != nullptr; activity = activity->Next())
+		{
+			if (!activity->Read(snapshot)) continue;
+
+			// Read the clock after the snapshot, so a handler that just started is never ahead of it
+			const std::uint64_t now = ReadTimestamp();
+			if (snapshot.startTicks >= now || now - snapshot.startTicks <= m_budgetTicks) continue;
+
+			// A handler call is identified by its record and start time; report it only once
+			std::uint64_t& reportedStart = m_reported[activity];
+			if (reportedStart == snapshot.startTicks) continue;
+			reportedStart = snapshot.startTicks;
+
+			HandlerOverrun overrun;
+			overrun.eventType = snapshot.eventType;
+			overrun.instance = snapshot.instance;
+			overrun.stub = snapshot.stub;
+			overrun.name = SubscriberNames::Find(snapshot.stub);
+			overrun.thread = snapshot.thread;
+			overrun.elapsed = TicksToNanoseconds(now - snapshot.startTicks);
+			{
+				std::lock_guard<std::mutex> lock(m_mutex);
+				++m_overruns;
+			}
+			if (m_report.IsBound())
+			{
+				m_report(overrun);
+			}
+		}
+	}
+
+	std::uint64_t m_budgetTicks;
+	Delegate<void(const HandlerOverrun&)> m_report;
+	std::chrono::milliseconds m_period;
+	std::unordered_map<const HandlerActivity*, std::uint64_t> m_reported; ///< Start of the last reported call per record. Watchdog thread only.
+
+	mutable std::mutex m_mutex;
+	std::condition_variable m_wake;
+	bool m_stopping = false;
+	std::uint64_t m_overruns = 0;
+	std::thread m_thread; ///< Declared last, so it starts after everything it uses is initialized.
+};
@@ -0,0 +1,113 @@
+#pragma once
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+#include "Timestamp.hpp"
+
+/// @brief Log-linear histogram of tick counts: every power of two is split into four buckets,
+/// so recorded values are kept within 25% while the whole histogram stays a fixed 2 KiB array.
+class LatencyHistogram
+{
+public:
+	static constexpr std::size_t SubBuckets = 4;
+	static constexpr std::size_t BucketCount = 64 * SubBuckets;
+
+	/// @brief Adds one measurement. A handful of instructions, no allocation.
+	void Record(std::uint64_t ticks)
+	{
+		++m_buckets[BucketOf(ticks)];
+		++m_count;
+		if (ticks > m_maxTicks)
+		{
+			m_maxTicks = ticks;
+		}
+	}
+
+	std::uint64_t Count() const
+	{
+		return m_count;
+	}
+
+	std::chrono::nanoseconds Max() const
+	{
+		return TicksToNanoseconds(m_maxTicks);
+	}
+
+	/// @brief Returns an upper bound of the given percentile of the recorded values.
+	/// @param percentile Between 0 and 100.
+	std::chrono::nanoseconds Percentile(double percentile) const
+	{
+		if (m_count == 0) return std::chrono::nanoseconds(0);
+
+		const auto rank = static_cast<std::uint64_t>(percentile / 100.0 * static_cast<double>(m_count - 1)) + 1;
+		std::uint64_t seen = 0;
+		for (std::size_t bucket = 0; bucket < BucketCount; ++bucket)
+		{
+			seen += m_buckets[bucket];
+			if (seen >= rank)
+			{
+				const std::uint64_t upper = UpperBoundOf(bucket);
+				return TicksToNanoseconds(upper < m_maxTicks ? upper : m_maxTicks);
+			}
+		}
+		return Max();
+	}
+
+	/// @brief Returns the number of values recorded into a bucket, for exporting the whole distribution.
+	std::uint64_t BucketValue(std::size_t bucket) const
+	{
+		return m_buckets[bucket];
+	}
+
+	/// @brief Returns the largest tick count falling into a bucket.
+	static std::uint64_t UpperBoundOf(std::size_t bucket)
+	{
+		const std::size_t exponent = bucket / SubBuckets;
+		const std::uint64_t sub = bucket % SubBuckets;
+		if (exponent == 0) return sub;
+
+		// Values of exponent e are 2^(e+1) .. 2^(e+2)-1 (with e >= 1); the bucket covers a quarter of that range
+		const std::uint64_t base = std::uint64_t{ 1 } << (exponent + 1);
+		const std::uint64_t width = base / SubBuckets;
+		return base + (sub + 1) * width - 1;
+	}
+
+private:
+	static std::size_t BucketOf(std::uint64_t ticks)
+	{
+		if (ticks < SubBuckets) return static_cast<std::size_t>(ticks);
+
+		// Two bits below the highest set bit pick the sub bucket
+		const std::size_t highest = HighestBit(ticks);
+		const std::size_t exponent = highest - 1;
+		const auto sub = static_cast<std::size_t>((ticks >> (highest - 2)) & (SubBuckets - 1));
+		return exponent * SubBuckets + sub;
+	}
+
+	static std::size_t HighestBit(std::uint64_t value)
+	{
+#if defined(__GNUC__) || defined(__clang__)
+		return 63 - static_cast<std::size_t>(__builtin_clzll(value));
+#elif defined(_MSC_VER) && defined(_M_X64)
+		unsigned long index;
+		_BitScanReverse64(&index, value);
+		return index;
+#else
+		std::size_t index = 0;
+		while (value >>= 1)
+		{
+			++index;
+		}
+		return index;
+#endif
+	}
+
+	std::array<std::uint64_t, BucketCount> m_buckets{};
+	std::uint64_t m_count = 0;
+	std::uint64_t m_maxTicks = 0;
+};
@@ -0,0 +1,382 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <typeinfo>
+#include <vector>
+
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "SubscriberName.hpp"
+#include "Timestamp.hpp"
+
+/// @brief Start of a live statistics segment. All fields are fixed size, so tools/bustop.cpp can read
+/// the segment of any process built for the same platform.
+struct LiveStatisticsHeader
+{
+	static constexpr char Magic[8] = { 'S', 'B', 'L', 'I', 'V', 'E', '\0', '\0' };
+	static constexpr std::uint32_t CurrentVersion = 1;
+
+	char magic[8];
+	std::uint32_t version;
+	std::uint32_t typeCapacity;        ///< Number of LiveTypeRecord entries following the header.
+	std::int64_t processId;
+	double ticksPerNanosecond;         ///< Converts handler ticks to time.
+	alignas(64) std::atomic<std::uint32_t> typeCount; ///< Number of records in use; a record is complete once counted.
+};
+
+/// @brief Counters of one event type. Writers serialize on the sequence, which is odd while the record changes;
+/// readers copy the counters and retry if the sequence changed meanwhile, so they never see a torn update.
+struct alignas(64) LiveTypeRecord
+{
+	std::atomic<std::uint32_t> sequence;
+	std::atomic<std::uint64_t> emits;
+	std::atomic<std::uint64_t> handlerTicks;    ///< Time spent in the type's subscribers, over all emits.
+	std::atomic<std::uint64_t> maxHandlerTicks; ///< Slowest single emit.
+	char name[96];                              ///< Readable type name, truncated and null terminated.
+};
+
+/// @brief Consistent copy of a LiveTypeRecord.
+struct LiveTypeCounters
+{
+	std::uint64_t emits = 0;
+	std::uint64_t handlerTicks = 0;
+	std::uint64_t maxHandlerTicks = 0;
+};
+
+/// @brief Reads a record of a live statistics segment, retrying while a writer updates it.
+/// @return False if the record kept changing; try again later.
+inline bool ReadLiveTypeRecord(const LiveTypeRecord& record, LiveTypeCounters& out)
+{
+	for (int attempt = 0; attempt < 64; ++attempt)
+	{
+		const std::uint32_t sequence = record.sequence.load(std::memory_order_acquire);
+		if ((sequence & 1) != 0) continue;
+
+		out.emits = record.emits.load(std::memory_order_relaxed);
+		out.handlerTicks = record.handlerTicks.load(std::memory_order_relaxed);
+		out.maxHandlerTicks = record.maxHandlerTicks.load(std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_acquire);
+		if (record.sequence.load(std::memory_order_relaxed) == sequence) return true;
+	}
+	return false;
+}
+
+/// @brief Publishes per event type emit counts and handler times of a SignalBus in a shared memory segment,
+/// so a running process can be inspected with tools/bustop.cpp without stopping it.
+/// Attach it with SignalBus::SetLiveStatistics; one segment may be shared by several buses and threads.
+/// Updating a record costs two timestamps and a short critical section on the record's sequence,
+/// which only threads emitting the same event type contend for.
+class LiveStatistics
+{
+public:
+	/// @brief Creates the segment and maps it. The segment is removed again by the destructor. A segment of the same name
+	/// is only replaced if the process that created it no longer runs, e.g. after a crash.
+	/// @param name The segment name, "/signalbus.<pid>" by default, which is what bustop looks for given a pid.
+	/// Give further instances of the same process their own names.
+	/// @param typeCapacity The number of event types that can be tracked; further types are not published.
+	/// @throws std::system_error if the segment can not be created or mapped, with std::errc::file_exists
+	/// if a running process (this one included) holds a segment of that name.
+	explicit LiveStatistics(std::string name = DefaultName(), std::size_t typeCapacity = 256)
+		: m_name(std::move(name)),
+		  m_size(sizeof(LiveStatisticsHeader) + typeCapacity * sizeof(LiveTypeRecord)),
+		  m_slots(new std::atomic<std::uint32_t>[CachedTypes]())
+	{
+		Map();
+
+		m_header = new (m_mapping) LiveStatisticsHeader();
+		std::memcpy(m_header->magic, LiveStatisticsHeader::Magic, sizeof(m_header->magic));
+		m_header->version = LiveStatisticsHeader::CurrentVersion;
+		m_header->typeCapacity = static_cast<std::uint32_t>(typeCapacity);
+		m_header->processId = CurrentProcessId();
+		m_header->ticksPerNanosecond = TimestampTicksPerNanosecond();
+		m_header->typeCount.store(0, std::memory_order_release);
+
+		m_records = reinterpret_cast<LiveTypeRecord*>(m_mapping + sizeof(LiveStatisticsHeader));
+	}
+
+	LiveStatistics(const LiveStatistics&) = delete;
+	auto operator=(const LiveStatistics&)->LiveStatistics & = delete;
+
+	~LiveStatistics()
+	{
+		Unmap();
+	}
+
+	/// @brief Returns the default segment name of the calling process.
+	static std::string DefaultName()
+	{
+		return "/signalbus." + std::to_string(CurrentProcessId());
+	}
+
+	/// @brief Counts one emit.
+	/// @tparam Event The type of the event.
+	/// @param handlerTicks ReadTimestamp ticks spent in the subscribers of the emit.
+	template <typename Event>
+	void Record(std::uint64_t handlerTicks)
+	{
+		LiveTypeRecord* record = RecordOf<Event>();
+		if (record == nullptr) return;
+
+		// Take the record by moving its sequence from even to odd
+		std::uint32_t sequence = record->sequence.load(std::memory_order_relaxed);
+		while ((sequence & 1) != 0 ||
+			!record->sequence.compare_exchange_weak(sequence, sequence + 1, std::memory_order_acquire, std::memory_order_relaxed))
+		{
+			sequence = record->sequence.load(std::memory_order_relaxed);
+		}
+		std::atomic_thread_fence(std::memory_order_release);
+
+		record->emits.store(record->emits.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+		record->handlerTicks.store(record->handlerTicks.load(std::memory_order_relaxed) + handlerTicks, std::memory_order_relaxed);
+		if (handlerTicks > record->maxHandlerTicks.load(std::memory_order_relaxed))
+		{
+			record->maxHandlerTicks.store(handlerTicks, std::memory_order_relaxed);
+		}
+
+		record->sequence.store(sequence + 2, std::memory_order_release);
+	}
+
+	/// @brief Returns the name of the segment.
+	const std::string& Name() const
+	{
+		return m_name;
+	}
+
+private:
+	static constexpr std::uint32_t Unregistered = ~std::uint32_t{ 0 };
+	static constexpr std::uint32_t CachedTypes = 4096; ///< Event types whose slot is cached per segment; later ones register on every emit.
+
+	/// @brief Returns the record of an event type, creating it the first time the type is counted.
+	/// Each segment caches the slots in its own table indexed by a process-wide id per type (0 until looked up,
+	/// the slot + 1 afterwards), so buses with different segments never evict each other's slots.
+	template <typename Event>
+	LiveTypeRecord* RecordOf()
+	{
+		static const std::uint32_t type = NextTypeId();
+		std::atomic<std::uint32_t>* cached = type < CachedTypes ? &m_slots[type] : nullptr;
+		std::uint32_t slot = cached != nullptr ? cached->load(std::memory_order_acquire) : 0;
+		if (slot == 0)
+		{
+			constexpr std::string_view name = SubscriberTypeNameOf<Event>();
+			const std::uint32_t index = Register(name.empty() ? std::string_view(typeid(Event).name()) : name);
+			slot = index != Unregistered ? index + 1 : Unregistered;
+			if (cached != nullptr) cached->store(slot, std::memory_order_release);
+		}
+		return slot != Unregistered ? &m_records[slot - 1] : nullptr;
+	}
+
+	/// @brief Finds or creates the record of a type name. Names are compared in full; only the copy in the
+	/// record, which is for display, is truncated.
+	std::uint32_t Register(std::string_view name)
+	{
+		std::lock_guard<std::mutex> lock(m_registerMutex);
+		const auto it = std::find(m_names.begin(), m_names.end(), name);
+		if (it != m_names.end()) return static_cast<std::uint32_t>(it - m_names.begin());
+
+		const auto count = static_cast<std::uint32_t>(m_names.size());
+		if (count == m_header->typeCapacity) return Unregistered;
+
+		LiveTypeRecord* record = new (&m_records[count]) LiveTypeRecord();
+		const std::size_t length = std::min(name.size(), sizeof(record->name) - 1);
+		std::memcpy(record->name, name.data(), length);
+		record->name[length] = '\0';
+		m_names.emplace_back(name);
+		m_header->typeCount.store(count + 1, std::memory_order_release);
+		return count;
+	}
+
+	/// @brief Dense id of an event type within the process, the index into the slot cache of every segment.
+	static std::uint32_t NextTypeId()
+	{
+		static std::atomic<std::uint32_t> next{ 0 };
+		return next.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	static std::int64_t CurrentProcessId()
+	{
+#if defined(_WIN32)
+		return static_cast<std::int64_t>(GetCurrentProcessId());
+#else
+		return static_cast<std::int64_t>(::getpid());
+#endif
+	}
+
+#if !defined(_WIN32)
+	/// @brief Names of the segments this process created and has not removed yet.
+	struct OwnedNames
+	{
+		std::mutex mutex;
+		std::vector<std::string> names;
+	};
+
+	static OwnedNames& Owned()
+	{
+		static OwnedNames owned;
+		return owned;
+	}
+
+	/// @brief Checks whether an existing segment of this name was left behind by a process that no longer runs.
+	/// Segments that are too small or lack the magic may be in the middle of being created, or not be ours; they are kept.
+	bool IsStale() const
+	{
+		const int file = ::shm_open(m_name.c_str(), O_RDONLY, 0);
+		if (file < 0) return errno == ENOENT;
+
+		struct stat status {};
+		void* mapping = MAP_FAILED;
+		if (::fstat(file, &status) == 0 && static_cast<std::size_t>(status.st_size) >= sizeof(LiveStatisticsHeader))
+		{
+			mapping = ::mmap(nullptr, sizeof(LiveStatisticsHeader), PROT_READ, MAP_SHARED, file, 0);
+		}
+		::close(file);
+		if (mapping == MAP_FAILED) return false;
+
+		const auto* header = static_cast<const LiveStatisticsHeader*>(mapping);
+		const bool valid = std::memcmp(header->magic, LiveStatisticsHeader::Magic, sizeof(header->magic)) == 0;
+		const std::int64_t processId = header->processId;
+		::munmap(mapping, sizeof(LiveStatisticsHeader));
+		if (!valid) return false;
+
+		// The caller checked that no instance of this process holds the name, so a segment recording this
+		// process id was left behind by an earlier process the id was reused from
+		if (processId == CurrentProcessId()) return true;
+		return ::kill(static_cast<pid_t>(processId), 0) != 0 && errno == ESRCH;
+	}
+
+	/// @brief Creates the segment, replacing a stale one of the same name. Called with the Owned() mutex held.
+	/// @return The file descriptor, or -1 with errno set.
+	int CreateSegment(const std::vector<std::string>& owned) const
+	{
+		if (std::find(owned.begin(), owned.end(), m_name) != owned.end())
+		{
+			errno = EEXIST;
+			return -1;
+		}
+
+		const int file = ::shm_open(m_name.c_str(), O_RDWR | O_CREAT | O_EXCL, 0644);
+		if (file >= 0 || errno != EEXIST) return file;
+		if (!IsStale())
+		{
+			errno = EEXIST;
+			return -1;
+		}
+
+		::shm_unlink(m_name.c_str());
+		return ::shm_open(m_name.c_str(), O_RDWR | O_CREAT | O_EXCL, 0644);
+	}
+#endif
+
+	void Map()
+	{
+#if defined(_WIN32)
+		// Named file mappings are the Windows counterpart of POSIX shared memory; they live as long as a handle does,
+		// so an existing one always belongs to a running process
+		const std::string mappingName = "Local\\" + m_name.substr(m_name.find_first_not_of('/'));
+		const auto size = static_cast<std::uint64_t>(m_size);
+		m_fileMapping = CreateFileMappingA(INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE, static_cast<DWORD>(size >> 32),
+			static_cast<DWORD>(size), mappingName.c_str());
+		if (m_fileMapping == nullptr) ThrowLastError("Can not create live statistics segment");
+		if (GetLastError() == ERROR_ALREADY_EXISTS)
+		{
+			CloseHandle(m_fileMapping);
+			m_fileMapping = nullptr;
+			SetLastError(ERROR_ALREADY_EXISTS);
+			ThrowLastError("Can not create live statistics segment");
+		}
+
+		m_mapping = static_cast<unsigned char*>(MapViewOfFile(m_fileMapping, FILE_MAP_ALL_ACCESS, 0, 0, m_size));
+		if (m_mapping == nullptr) ThrowLastError("Can not map live statistics segment");
+		std::memset(m_mapping, 0, m_size);
+#else
+		int file;
+		{
+			OwnedNames& owned = Owned();
+			std::lock_guard<std::mutex> lock(owned.mutex);
+			file = CreateSegment(owned.names);
+			if (file >= 0)
+			{
+				owned.names.push_back(m_name);
+				m_created = true;
+			}
+		}
+		if (file < 0) ThrowLastError("Can not create live statistics segment");
+		if (::ftruncate(file, static_cast<off_t>(m_size)) != 0)
+		{
+			const int error = errno;
+			::close(file);
+			errno = error;
+			ThrowLastError("Can not size live statistics segment");
+		}
+
+		void* mapping = ::mmap(nullptr, m_size, PROT_READ | PROT_WRITE, MAP_SHARED, file, 0);
+		::close(file);
+		if (mapping == MAP_FAILED) ThrowLastError("Can not map live statistics segment");
+		m_mapping = static_cast<unsigned char*>(mapping);
+#endif
+	}
+
+	void Unmap() noexcept
+	{
+#if defined(_WIN32)
+		if (m_mapping != nullptr) UnmapViewOfFile(m_mapping);
+		if (m_fileMapping != nullptr) CloseHandle(m_fileMapping);
+#else
+		if (m_mapping != nullptr) ::munmap(m_mapping, m_size);
+		if (!m_created) return;
+
+		OwnedNames& owned = Owned();
+		std::lock_guard<std::mutex> lock(owned.mutex);
+		::shm_unlink(m_name.c_str());
+		owned.names.erase(std::find(owned.names.begin(), owned.names.end(), m_name));
+		m_created = false;
+#endif
+	}
+
+	[[noreturn]] void ThrowLastError(const char* what)
+	{
+#if defined(_WIN32)
+		const std::error_code error(static_cast<int>(GetLastError()), std::system_category());
+#else
+		const std::error_code error(errno, std::generic_category());
+#endif
+		Unmap();
+		throw std::system_error(error, what);
+	}
+
+	std::string m_name;
+	std::size_t m_size;
+#if defined(_WIN32)
+	HANDLE m_fileMapping = nullptr;
+#else
+	bool m_created = false;
+#endif
+	unsigned char* m_mapping = nullptr;
+
+	LiveStatisticsHeader* m_header = nullptr;
+	LiveTypeRecord* m_records = nullptr;
+	std::unique_ptr<std::atomic<std::uint32_t>[]> m_slots; ///< Cached record slot + 1 per type id, 0 until looked up.
+	std::vector<std::string> m_names;                        ///< Full type names of the records, guarded by m_registerMutex.
+	std::mutex m_registerMutex;
+};
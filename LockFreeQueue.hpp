@@ -0,0 +1,195 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <utility>
+
+/// @brief Size used to keep independently written atomics on separate cache lines.
+constexpr std::size_t CacheLineSize = 64;
+
+/// @brief Bounded lock-free queue for any number of producers and consumers (Vyukov's array queue).
+/// @tparam T The type of the stored values. Has to be move constructible.
+template <typename T>
+class BoundedMpmcQueue
+{
+public:
+	/// @brief Creates the queue.
+	/// @param capacity The maximum number of queued values, rounded up to a power of two.
+	explicit BoundedMpmcQueue(std::size_t capacity)
+	{
+		std::size_t size = 2;
+		while (size < capacity)
+		{
+			size *= 2;
+		}
+		m_mask = size - 1;
+		m_cells = std::make_unique<Cell[]>(size);
+		for (std::size_t i = 0; i < size; ++i)
+		{
+			m_cells[i].sequence.store(i, std::memory_order_relaxed);
+		}
+	}
+
+	BoundedMpmcQueue(const BoundedMpmcQueue&) = delete;
+	auto operator=(const BoundedMpmcQueue&)->BoundedMpmcQueue & = delete;
+
+	~BoundedMpmcQueue()
+	{
+		T value;
+		while (TryPop(value)) {}
+	}
+
+	/// @brief Appends a value if the queue is not full.
+	/// @return False if the queue is full; the value is left untouched then.
+	bool TryPush(T& value)
+	{
+		std::size_t position = m_enqueue.load(std::memory_order_relaxed);
+		Cell* cell;
+		while (true)
+		{
+			cell = &m_cells[position & m_mask];
+			const std::size_t sequence = cell->sequence.load(std::memory_order_acquire);
+			const auto difference = static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(position);
+			if (difference == 0)
+			{
+				if (m_enqueue.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) break;
+			}
+			else if (difference < 0)
+			{
+				return false;
+			}
+			else
+			{
+				position = m_enqueue.load(std::memory_order_relaxed);
+			}
+		}
+
+		new (cell->storage) T(std::move(value));
+		cell->sequence.store(position + 1, std::memory_order_release);
+		return true;
+	}
+
+	/// @brief Removes the oldest value if the queue is not empty.
+	/// @param out Receives the value.
+	/// @return False if the queue is empty.
+	bool TryPop(T& out)
+	{
+		std::size_t position = m_dequeue.load(std::memory_order_relaxed);
+		Cell* cell;
+		while (true)
+		{
+			cell = &m_cells[position & m_mask];
+			const std::size_t sequence = cell->sequence.load(std::memory_order_acquire);
+			const auto difference = static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(position + 1);
+			if (difference == 0)
+			{
+				if (m_dequeue.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) break;
+			}
+			else if (difference < 0)
+			{
+				return false;
+			}
+			else
+			{
+				position = m_dequeue.load(std::memory_order_relaxed);
+			}
+		}
+
+		T* stored = std::launder(reinterpret_cast<T*>(cell->storage));
+		out = std::move(*stored);
+		stored->~T();
+		cell->sequence.store(position + m_mask + 1, std::memory_order_release);
+		return true;
+	}
+
+	/// @brief Returns the number of queued values. Only approximate while other threads push or pop.
+	std::size_t SizeApprox() const
+	{
+		const std::size_t enqueued = m_enqueue.load(std::memory_order_relaxed);
+		const std::size_t dequeued = m_dequeue.load(std::memory_order_relaxed);
+		return enqueued > dequeued ? enqueued - dequeued : 0;
+	}
+
+private:
+	struct Cell
+	{
+		std::atomic<std::size_t> sequence{ 0 };
+		alignas(T) unsigned char storage[sizeof(T)];
+	};
+
+	std::unique_ptr<Cell[]> m_cells;
+	std::size_t m_mask = 0;
+	alignas(CacheLineSize) std::atomic<std::size_t> m_enqueue{ 0 };
+	alignas(CacheLineSize) std::atomic<std::size_t> m_dequeue{ 0 };
+};
+
+/// @brief Bounded lock-free queue for exactly one producer thread and one consumer thread.
+/// @tparam T The type of the stored values. Has to be default constructible and move assignable.
+template <typename T>
+class SpscQueue
+{
+public:
+	/// @brief Creates the queue.
+	/// @param capacity The maximum number of queued values, rounded up to a power of two.
+	explicit SpscQueue(std::size_t capacity)
+	{
+		std::size_t size = 2;
+		while (size < capacity)
+		{
+			size *= 2;
+		}
+		m_mask = size - 1;
+		m_values = std::make_unique<T[]>(size);
+	}
+
+	SpscQueue(const SpscQueue&) = delete;
+	auto operator=(const SpscQueue&)->SpscQueue & = delete;
+
+	/// @brief Appends a value if the queue is not full. Producer thread only.
+	/// @return False if the queue is full; the value is left untouched then.
+	bool TryPush(T& value)
+	{
+		const std::size_t tail = m_tail.load(std::memory_order_relaxed);
+		if (tail - m_cachedHead > m_mask)
+		{
+			m_cachedHead = m_head.load(std::memory_order_acquire);
+			if (tail - m_cachedHead > m_mask) return false;
+		}
+
+		m_values[tail & m_mask] = std::move(value);
+		m_tail.store(tail + 1, std::memory_order_release);
+		return true;
+	}
+
+	/// @brief Removes the oldest value if the queue is not empty. Consumer thread only.
+	/// @param out Receives the value.
+	/// @return False if the queue is empty.
+	bool TryPop(T& out)
+	{
+		const std::size_t head = m_head.load(std::memory_order_relaxed);
+		if (head == m_cachedTail)
+		{
+			m_cachedTail = m_tail.load(std::memory_order_acquire);
+			if (head == m_cachedTail) return false;
+		}
+
+		out = std::move(m_values[head & m_mask]);
+		m_head.store(head + 1, std::memory_order_release);
+		return true;
+	}
+
+	/// @brief Returns the number of queued values. Only approximate while the other side is active.
+	std::size_t SizeApprox() const
+	{
+		return m_tail.load(std::memory_order_relaxed) - m_head.load(std::memory_order_relaxed);
+	}
+
+private:
+	std::unique_ptr<T[]> m_values;
+	std::size_t m_mask = 0;
+	alignas(CacheLineSize) std::atomic<std::size_t> m_head{ 0 }; ///< Written by the consumer.
+	std::size_t m_cachedTail = 0;                                 ///< Consumer's copy of m_tail.
+	alignas(CacheLineSize) std::atomic<std::size_t> m_tail{ 0 }; ///< Written by the producer.
+	std::size_t m_cachedHead = 0;                                 ///< Producer's copy of m_head.
+};
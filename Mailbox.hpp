@@ -0,0 +1,44 @@
+#pragma once
+#include <cstddef>
+#include <deque>
+#include <utility>
+
+/// @brief FIFO queue that can be bound as the receiver of a SignalBus event type, collecting
+/// sent (possibly move-only) events until their owner takes them.
+/// bus.BindReceiver<Event, Mailbox<Event>, &Mailbox<Event>::Receive>(&mailbox)
+/// @tparam T The type of the events.
+template <typename T>
+class Mailbox
+{
+public:
+	/// @brief Takes ownership of an event.
+	void Receive(T&& event)
+	{
+		m_events.push_back(std::move(event));
+	}
+
+	/// @brief Moves the oldest event out of the mailbox.
+	/// @param out Receives the event.
+	/// @return False if the mailbox is empty.
+	bool TryTake(T& out)
+	{
+		if (m_events.empty()) return false;
+
+		out = std::move(m_events.front());
+		m_events.pop_front();
+		return true;
+	}
+
+	std::size_t Size() const
+	{
+		return m_events.size();
+	}
+
+	bool Empty() const
+	{
+		return m_events.empty();
+	}
+
+private:
+	std::deque<T> m_events;
+};
@@ -0,0 +1,163 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include "LockFreeQueue.hpp"
+#include "SignalBus.hpp"
+
+/// @brief Extracts the partition key of an event. By default calls the event's PartitionKey() member;
+/// specialize it for event types that can not declare one themselves.
+/// @tparam Event The type of the event.
+template <typename Event>
+struct PartitionKeyOf
+{
+	auto operator()(const Event& event) const
+	{
+		return event.PartitionKey();
+	}
+};
+
+/// @brief Delivers an event type on several worker lanes while keeping the order of events with the same key.
+/// Every event is hashed by its key to one lane; each lane has its own SPSC queue and thread that emits
+/// the event on the bus. Events of one key are therefore delivered in publish order, events of different
+/// keys run in parallel, so subscribers of the event type have to tolerate concurrent calls for different keys.
+/// Publish has to be called from a single producer thread, and the bus must not be modified while lanes run.
+/// @tparam Event The type of the event. Has to be default constructible and movable.
+template <typename Event>
+class PartitionedDispatcher
+{
+public:
+	/// @brief Creates the dispatcher and starts its lanes.
+	/// @param bus The bus whose subscribers receive the events.
+	/// @param laneCount The number of lanes (worker threads).
+	/// @param capacityPerLane The capacity of each lane's queue.
+	/// @throws std::invalid_argument if laneCount is 0.
+	PartitionedDispatcher(SignalBus& bus, std::size_t laneCount, std::size_t capacityPerLane = 1024)
+		: m_bus(bus)
+	{
+		if (laneCount == 0) throw std::invalid_argument("PartitionedDispatcher needs at least one lane");
+
+		m_lanes.reserve(laneCount);
+		for (std::size_t i = 0; i < laneCount; ++i)
+		{
+			m_lanes.push_back(std::make_unique<Lane>(capacityPerLane));
+		}
+		for (auto& lane : m_lanes)
+		{
+			lane->thread = std::thread([this, lanePointer = lane.get()] { Run(*lanePointer); });
+		}
+	}
+
+	PartitionedDispatcher(const PartitionedDispatcher&) = delete;
+	auto operator=(const PartitionedDispatcher&)->PartitionedDispatcher & = delete;
+
+	~PartitionedDispatcher()
+	{
+		Stop();
+	}
+
+	/// @brief Queues an event on the lane of its key, yielding while that lane is full.
+	/// @param event The event.
+	void Publish(Event event)
+	{
+		Lane& lane = *m_lanes[LaneOf(event)];
+		while (!lane.queue.TryPush(event))
+		{
+			std::this_thread::yield();
+		}
+		if (lane.sleeping.load(std::memory_order_acquire))
+		{
+			std::lock_guard<std::mutex> lock(lane.mutex);
+			lane.wake.notify_one();
+		}
+	}
+
+	/// @brief Returns the lane an event is delivered on.
+	std::size_t LaneOf(const Event& event) const
+	{
+		const auto key = PartitionKeyOf<Event>{}(event);
+		const std::uint64_t hash = static_cast<std::uint64_t>(std::hash<std::decay_t<decltype(key)>>{}(key));
+
+		// Fibonacci mixing, std::hash of integers is usually the identity
+		return static_cast<std::size_t>((hash * 0x9E3779B97F4A7C15ull) >> 32) % m_lanes.size();
+	}
+
+	/// @brief Delivers every queued event, then joins the lane threads.
+	void Stop()
+	{
+		m_stopping.store(true, std::memory_order_release);
+		for (auto& lane : m_lanes)
+		{
+			{
+				std::lock_guard<std::mutex> lock(lane->mutex);
+				lane->wake.notify_one();
+			}
+			if (lane->thread.joinable())
+			{
+				lane->thread.join();
+			}
+		}
+	}
+
+	std::size_t LaneCount() const
+	{
+		return m_lanes.size();
+	}
+
+private:
+	struct Lane
+	{
+		explicit Lane(std::size_t capacity)
+			: queue(capacity) {}
+
+		SpscQueue<Event> queue;
+		std::atomic<bool> sleeping{ false };
+		std::mutex mutex;
+		std::condition_variable wake;
+		std::thread thread;
+	};
+
+	void Run(Lane& lane)
+	{
+		Event event;
+		while (true)
+		{
+			if (lane.queue.TryPop(event))
+			{
+				m_bus.Emit<Event>(event);
+				continue;
+			}
+
+			if (m_stopping.load(std::memory_order_acquire))
+			{
+				// Recheck after observing the stop request, events published before Stop must still be delivered
+				if (!lane.queue.TryPop(event)) return;
+
+				m_bus.Emit<Event>(event);
+				continue;
+			}
+
+			// Bounded wait, so a wake-up lost to a race only delays the lane briefly
+			lane.sleeping.store(true, std::memory_order_release);
+			{
+				std::unique_lock<std::mutex> lock(lane.mutex);
+				lane.wake.wait_for(lock, std::chrono::milliseconds(1));
+			}
+			lane.sleeping.store(false, std::memory_order_release);
+		}
+	}
+
+	SignalBus& m_bus;
+	std::vector<std::unique_ptr<Lane>> m_lanes;
+	std::atomic<bool> m_stopping{ false };
+};
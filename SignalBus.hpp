@@ -1,26 +1,374 @@
 #pragma once
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <iterator>
 #include <memory>
 #include <string>
+#include <type_traits>
 #include <typeindex>
 #include <unordered_map>
+#include <utility>
+#include <vector>
 
+#include "AllocationTracker.hpp"
+#include "CompactDelegate.hpp"
 #include "Delegate.hpp"
+#include "EventChannel.hpp"
+#include "EventQueue.hpp"
+#include "FlightRecorder.hpp"
+#include "LiveStatistics.hpp"
+#include "SubscriptionGroup.hpp"
+#include "SubscriptionNode.hpp"
 
+/// @brief Thrown when a forwarding rule or parent would make an event travel in a circle between buses.
+class ForwardingCycle : public std::exception
+{
+public:
+    const char* what() const noexcept override
+    {
+        return "Forwarding rule would create a cycle between buses";
+    }
+};
 
 class SignalBus
 {
 public:
-    /// @brief Emits an event to all bound delegates of the specified type.
+    SignalBus()
+        : m_tracker(std::make_shared<AllocationTracker>()),
+          m_map(0, std::hash<std::type_index>{}, std::equal_to<std::type_index>{}, MapAllocator(m_tracker.get(), AllocationCategory::Map)),
+          m_groups(0, std::hash<std::string>{}, std::equal_to<std::string>{}, GroupMapAllocator(m_tracker.get(), AllocationCategory::Map)),
+          m_queue(m_tracker.get())
+    {
+    }
+
+    SignalBus(const SignalBus&) = delete;
+    auto operator=(const SignalBus&)->SignalBus & = delete;
+
+    SignalBus(SignalBus&& other) noexcept
+        : m_tracker(std::move(other.m_tracker)),
+          m_sharedTrackers(std::move(other.m_sharedTrackers)),
+          m_map(std::move(other.m_map)),
+          m_groups(std::move(other.m_groups)),
+          m_hierarchy(std::move(other.m_hierarchy)),
+          m_queue(std::move(other.m_queue)),
+          m_recorder(other.m_recorder),
+          m_statistics(other.m_statistics)
+    {
+        if (m_hierarchy != nullptr)
+        {
+            m_hierarchy->bus = this;
+        }
+    }
+
+    auto operator=(SignalBus&& other) noexcept -> SignalBus&
+    {
+        // Swap instead of member-wise assignment, the previous channels have to be released before their trackers
+        std::swap(m_tracker, other.m_tracker);
+        std::swap(m_sharedTrackers, other.m_sharedTrackers);
+        m_map.swap(other.m_map);
+        m_groups.swap(other.m_groups);
+        m_hierarchy.swap(other.m_hierarchy);
+        m_queue.Swap(other.m_queue);
+        std::swap(m_recorder, other.m_recorder);
+        std::swap(m_statistics, other.m_statistics);
+        if (m_hierarchy != nullptr)
+        {
+            m_hierarchy->bus = this;
+        }
+        if (other.m_hierarchy != nullptr)
+        {
+            other.m_hierarchy->bus = &other;
+        }
+        return *this;
+    }
+
+    ~SignalBus()
+    {
+        if (m_hierarchy == nullptr) return;
+
+        // Forwarding links point into the maps of related buses, remove them while both sides are alive
+        SetParent(nullptr);
+        while (!m_hierarchy->children.empty())
+        {
+            m_hierarchy->children.back()->bus->SetParent(nullptr);
+        }
+    }
+
+    /// @brief Creates a new bus with all the subscriptions of this one in O(number of event types).
+    /// Subscriber lists are shared between both buses and only copied once either side binds or unbinds
+    /// for that event type. The fork gets its own copy of every subscription group, in the same muted state,
+    /// so muting a group on one bus does not affect the other; the lists of event types with group subscribers
+    /// are therefore copied right away. The receiver of sent events is the single owner of what it is sent and is not
+    /// forked: Send on the fork returns false until a receiver is bound there; lists of event types with a receiver
+    /// are copied right away without it. Intrusive subscriptions (SubscriptionNode) belong to their node and are not forked,
+    /// neither are the parent, the children, the forwarding rules and queued events. The fork records into the same FlightRecorder. The fork has its own AllocationTracker; shared lists stay accounted to the bus
+    /// that allocated them until they are copied. Forking has to be synchronized with other use of this bus,
+    /// afterwards both buses may be used independently (also from different threads).
+    /// @return The forked bus.
+    SignalBus Fork() const
+    {
+        SignalBus fork;
+        fork.m_sharedTrackers.reserve(m_sharedTrackers.size() + 1);
+        fork.m_sharedTrackers = m_sharedTrackers;
+        fork.m_sharedTrackers.push_back(m_tracker);
+
+        GroupMapping groups;
+        groups.reserve(m_groups.size());
+        const TrackingAllocator<SubscriptionGroupState> groupAllocator(fork.m_tracker.get(), AllocationCategory::Lists);
+        for (const auto& [name, group] : m_groups)
+        {
+            auto copy = std::allocate_shared<SubscriptionGroupState>(groupAllocator, name);
+            copy->muted.store(group.IsMuted(), std::memory_order_relaxed);
+            groups.emplace_back(group.State().get(), copy);
+            fork.m_groups.emplace(name, SubscriptionGroup(std::move(copy)));
+        }
+
+        fork.m_map.reserve(m_map.size());
+        for (const auto& [type, entry] : m_map)
+        {
+            AllocationCounters* typeCounters = &fork.m_tracker->TypeCounters(type);
+            EventChannelPtr channel = entry.channel;
+            if (channel->HasGroups() || channel->HasReceiver())
+            {
+                channel = channel->CloneChannel(fork.m_tracker.get(), typeCounters);
+                channel->RemapGroups(groups);
+                channel->UnbindReceiver();
+                if (channel->Empty())
+                {
+                    continue;
+                }
+            }
+            fork.m_map.try_emplace(type, std::move(channel), fork.m_tracker.get(), typeCounters);
+        }
+        fork.m_recorder = m_recorder;
+        fork.m_statistics = m_statistics;
+        return fork;
+    }
+
+    /// @brief Emits an event to all bound delegates of the specified type, then along the forwarding rules
+    /// of that type to the parent and/or children buses. Subscribers of the same kind (member function handles,
+    /// by-value delegates, compact delegates, a subscription group, intrusive nodes) are called in bind order;
+    /// the order across kinds is unspecified.
    /// @tparam EventToEmit The type of the event to emit.
-   /// @param data The event data to pass to the delegates.
+   /// @param data The event data to pass to the delegates. It is passed on by reference, never copied.
     template <typename EventToEmit>
-    void Emit(EventToEmit data)
+    void Emit(const EventToEmit& data)
+    {
+        if (m_recorder != nullptr)
+        {
+            m_recorder->Record(data);
+        }
+
+        const auto it = m_map.find(typeid(EventToEmit));
+        if (it == m_map.end()) // Nobody is bound, do not create an empty channel
+        {
+            if (m_statistics != nullptr)
+            {
+                m_statistics->Record<EventToEmit>(0);
+            }
+            return;
+        }
+
+        if (m_statistics == nullptr)
+        {
+            EmitEntry(it->second, data);
+            return;
+        }
+
+        const std::uint64_t start = ReadTimestamp();
+        EmitEntry(it->second, data);
+        m_statistics->Record<EventToEmit>(ReadTimestamp() - start);
+    }
+
+    /// @brief Queues a copy of an event instead of emitting it right away. Queued events are emitted by
+    /// DispatchFor, higher priorities first; inside a priority earliest deadline first, then in the order
+    /// they were enqueued, across all event types.
+    /// @tparam EventToEnqueue The type of the event. Has to be copy constructible.
+    /// @param event The event to queue.
+    /// @param options Priority and optional deadline; an event not dispatched by its deadline is dropped.
+    /// @return A handle that can retract the event before it is dispatched.
+    template <typename EventToEnqueue>
+    QueuedEvent Enqueue(const EventToEnqueue& event, const EnqueueOptions& options = {})
+    {
+        return m_queue.Push(event, &DispatchQueued<EventToEnqueue>, options);
+    }
+
+    /// @brief Emits queued events in queue order (see Enqueue) until the budget is used up. The rest stays queued for the
+    /// next call, as do events enqueued by the handlers during this call, whatever their priority or deadline.
+    /// @param budget Maximum number of events and/or time to spend; unlimited by default.
+    /// @return The number of dispatched events.
+    std::size_t DispatchFor(const DispatchBudget& budget = {})
+    {
+        return m_queue.Dispatch(this, budget);
+    }
+
+    /// @brief Drops every queued event without emitting it.
+    void ClearQueue()
+    {
+        m_queue.Clear();
+    }
+
+    /// @brief Returns the backlog metrics of the queue: pending events, age of the oldest one, waiting times of dispatched ones
+    /// and the number of events dropped after their deadline or cancelled.
+    QueueStats GetQueueStats() const
+    {
+        return m_queue.Stats();
+    }
+
+#if SIGNALBUS_QUEUE_LATENCY
+    /// @brief Returns the distribution of enqueue-to-handler latencies of an event type: the time its queued
+    /// events waited from Enqueue until DispatchFor started emitting them. Compiled out with SIGNALBUS_QUEUE_LATENCY=0.
+    /// @tparam Event The type of the event.
+    template <typename Event>
+    LatencyHistogram GetQueueLatency() const
+    {
+        return m_queue.Latency<Event>();
+    }
+#endif
+
+    /// @brief Records every emit of this bus, subscribed or not, into a flight recorder. Forwarded emits are
+    /// recorded by the bus they were emitted on only.
+    /// @param recorder The recorder, or nullptr to stop recording. Has to outlive the attachment.
+    void SetFlightRecorder(FlightRecorder* recorder)
+    {
+        m_recorder = recorder;
+    }
+
+    /// @brief Publishes the emit count and handler time of every event type emitted on this bus into a shared
+    /// memory segment, for tools/bustop.cpp. Forwarded emits are timed as part of the emit on this bus.
+    /// @param statistics The segment, or nullptr to stop publishing. Has to outlive the attachment.
+    void SetLiveStatistics(LiveStatistics* statistics)
+    {
+        m_statistics = statistics;
+    }
+
+    /// @brief Makes this bus a child of another bus, or with nullptr detaches it from its parent.
+    /// Forwarding rules of both sides are applied to the new relationship; the links to the previous parent are removed.
+    /// A bus has to outlive none of its relatives: destroying it detaches it from its parent and its children.
+    /// @param parent The new parent bus. Must not be this bus or one of its descendants.
+    void SetParent(SignalBus* parent)
+    {
+        HierarchyNode& self = Hierarchy();
+        if (self.parent != nullptr)
+        {
+            if (self.parent->bus == parent) return;
+            Detach(*self.parent->bus, *this);
+        }
+        if (parent == nullptr) return;
+
+        HierarchyNode& parentNode = parent->Hierarchy();
+        for (const HierarchyNode* ancestor = &parentNode; ancestor != nullptr; ancestor = ancestor->parent)
+        {
+            if (ancestor == &self) throw ForwardingCycle();
+        }
+
+        self.parent = &parentNode;
+        parentNode.children.push_back(&self);
+        try
+        {
+            for (const ForwardRule& rule : parentNode.childRules)
+            {
+                rule.link(*parent, *this, rule.filter);
+            }
+            for (const ForwardRule& rule : self.parentRules)
+            {
+                rule.link(*this, *parent, rule.filter);
+            }
+        }
+        catch (...)
+        {
+            Detach(*parent, *this);
+            throw;
+        }
+    }
+
+    /// @brief Returns the parent bus, or nullptr if this bus has none.
+    SignalBus* GetParent() const
+    {
+        return m_hierarchy != nullptr && m_hierarchy->parent != nullptr ? m_hierarchy->parent->bus : nullptr;
+    }
+
+    /// @brief Forwards every emit of an event type on this bus to the parent bus, the current one and any later one.
+    /// The link to the parent's subscriber lists is resolved here; emitting follows it without a map lookup or a copy.
+    /// Forwarding is transitive: the parent's own rules for the type apply to forwarded events as well.
+    /// Replaces a previous parent rule of the same type.
+    /// @tparam Event The type of the event to forward.
+    /// @param filter Optional predicate (function or captureless lambda); only events it accepts are forwarded.
+    /// @throws ForwardingCycle if the parent already forwards the type back to this bus.
+    template <typename Event>
+    void ForwardToParent(bool(*filter)(const Event&) = nullptr)
+    {
+        StopForwardingToParent<Event>();
+
+        HierarchyNode& self = Hierarchy();
+        const ForwardRule rule{ typeid(Event), reinterpret_cast<ErasedFilter>(filter), &Link<Event> };
+        if (self.parent != nullptr)
+        {
+            Link<Event>(*this, *self.parent->bus, rule.filter);
+        }
+        self.parentRules.push_back(rule);
+    }
+
+    /// @brief Forwards every emit of an event type on this bus to all children, current and future ones.
+    /// Replaces a previous child rule of the same type.
+    /// @tparam Event The type of the event to forward.
+    /// @param filter Optional predicate (function or captureless lambda); only events it accepts are forwarded.
+    /// @throws ForwardingCycle if a child already forwards the type back to this bus.
+    template <typename Event>
+    void ForwardToChildren(bool(*filter)(const Event&) = nullptr)
+    {
+        StopForwardingToChildren<Event>();
+
+        HierarchyNode& self = Hierarchy();
+        const ForwardRule rule{ typeid(Event), reinterpret_cast<ErasedFilter>(filter), &Link<Event> };
+        try
+        {
+            for (HierarchyNode* child : self.children)
+            {
+                Link<Event>(*this, *child->bus, rule.filter);
+            }
+        }
+        catch (...)
+        {
+            for (HierarchyNode* child : self.children)
+            {
+                RemoveLinks(*this, *child, typeid(Event));
+            }
+            throw;
+        }
+        self.childRules.push_back(rule);
+    }
+
+    /// @brief Stops forwarding an event type to the parent bus.
+    /// @tparam Event The type of the event.
+    template <typename Event>
+    void StopForwardingToParent()
     {
-	    for (auto& element : m_map[typeid(EventToEmit)])
-	    {
-           auto casted= dynamic_cast<DelegateHandle<EventToEmit>*>( element.get());
-           casted->Emit(data);
-	    }
+        if (m_hierarchy == nullptr) return;
+
+        EraseRule(m_hierarchy->parentRules, typeid(Event));
+        if (m_hierarchy->parent != nullptr)
+        {
+            RemoveLinks(*this, *m_hierarchy->parent, typeid(Event));
+        }
+    }
+
+    /// @brief Stops forwarding an event type to the children buses.
+    /// @tparam Event The type of the event.
+    template <typename Event>
+    void StopForwardingToChildren()
+    {
+        if (m_hierarchy == nullptr) return;
+
+        EraseRule(m_hierarchy->childRules, typeid(Event));
+        for (HierarchyNode* child : m_hierarchy->children)
+        {
+            RemoveLinks(*this, *child, typeid(Event));
+        }
     }
 
     /// @brief Binds a member function of a specific class instance to an event.
@@ -32,10 +380,226 @@ public:
     void Bind(ClassToBind* instance)
     {
         Delegate<void(const EventToBindInto&)> delegate;
-        delegate.Bind<ClassToBind, MemberFunction>(instance);
+        delegate.template Bind<ClassToBind, MemberFunction>(instance);
+
+        AllocationCounters* typeCounters = &m_tracker->TypeCounters(typeid(EventToBindInto));
+        auto handle = DelegateHandle<EventToBindInto>::Create(delegate, {m_tracker.get(), AllocationCategory::Handles, typeCounters});
+        GetChannel<EventToBindInto>().handles.push_back(std::move(handle));
+    }
+
+    /// @brief Designates the single receiver of an event type for Send. Replaces the previous receiver, if any.
+    /// The receiver takes the event by rvalue reference, so move-only payloads (buffers, handles) change owner without a copy.
+    /// @tparam EventToReceive The type of the event.
+    /// @tparam ClassToBind The type of the class containing the member function.
+    /// @tparam MemberFunction The member function taking ownership of sent events.
+    /// @param instance A pointer to the receiving instance, e.g. a Mailbox.
+    template <typename EventToReceive, typename ClassToBind, void(ClassToBind::* MemberFunction)(EventToReceive&&)>
+    void BindReceiver(ClassToBind* instance)
+    {
+        GetChannel<EventToReceive>().receiver.template Bind<ClassToBind, MemberFunction>(instance);
+    }
+
+    /// @brief Removes the receiver of an event type.
+    /// @tparam EventToReceive The type of the event.
+    template <typename EventToReceive>
+    void UnbindReceiver()
+    {
+        const auto it = m_map.find(typeid(EventToReceive));
+        if (it == m_map.end()) return; // No such event is bound
 
-        auto handle = std::make_unique<DelegateHandle<EventToBindInto>>(delegate);
-        m_map[typeid(EventToBindInto)].push_back(std::move(handle));
+        MakeUnique<EventToReceive>(it).receiver = {};
+        EraseIfEmpty(it);
+    }
+
+    /// @brief Moves an event into the receiver of its type. Unlike Emit, exactly one consumer gets the event,
+    /// so the event type may be move-only. Subscribers bound for Emit are not involved.
+    /// @tparam EventToSend The type of the event to send.
+    /// @param event The event. Only moved from if it was delivered.
+    /// @return True if a receiver took the event; false if the event type has no receiver.
+    template <typename EventToSend>
+    bool Send(EventToSend&& event)
+    {
+        static_assert(!std::is_lvalue_reference_v<EventToSend>, "Send transfers ownership, pass the event as an rvalue");
+
+        const auto it = m_map.find(typeid(EventToSend));
+        if (it == m_map.end()) return false;
+
+        const auto& receiver = static_cast<const EventChannel<EventToSend>*>(it->second.channel.get())->receiver;
+        if (!receiver.IsBound()) return false;
+
+#if SIGNALBUS_WATCHDOG
+        HandlerScope scope(typeid(EventToSend), receiver.Instance(), receiver.StubAddress());
+#endif
+        receiver(std::move(event));
+        return true;
+    }
+
+    /// @brief Binds a member function of many instances at once. The subscriber list is looked up once,
+    /// grown once and the delegates are appended by value, without a handle allocation per instance.
+    /// @tparam EventToBindInto The type of the event to bind to.
+    /// @tparam ClassToBind The type of the class containing the member function.
+    /// @tparam MemberFunction The member function to bind.
+    /// @tparam Range A contiguous range of ClassToBind pointers, e.g. std::span<ClassToBind*> or std::vector<ClassToBind*>.
+    /// @param instances The instances to bind.
+    template <typename EventToBindInto, typename ClassToBind, void(ClassToBind::* MemberFunction)(const EventToBindInto&), typename Range>
+    void BindMany(const Range& instances)
+    {
+        const auto* first = std::data(instances);
+        const std::size_t count = std::size(instances);
+        static_assert(std::is_convertible_v<decltype(*first), ClassToBind*>, "BindMany expects a range of instance pointers");
+
+        auto& delegates = GetChannel<EventToBindInto>().delegates;
+        ReserveAdditional(delegates, count);
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            Delegate<void(const EventToBindInto&)> delegate;
+            delegate.template Bind<ClassToBind, MemberFunction>(first[i]);
+            delegates.push_back(delegate);
+        }
+    }
+
+    /// @brief Reserves room for subscriptions of an event type, so binding many of them does not regrow the list.
+    /// Applies to the lists used by Bind with a member function and by BindCompact; BindMany reserves on its own.
+    /// @tparam Event The type of the event.
+    /// @param count The number of subscriptions to reserve room for, in addition to the existing ones.
+    template <typename Event>
+    void Reserve(std::size_t count)
+    {
+        auto& channel = GetChannel<Event>();
+        ReserveAdditional(channel.handles, count);
+        ReserveAdditional(channel.compact, count);
+    }
+
+    /// @brief Binds a const member function of a specific class instance to an event.
+    /// The delegate is stored by value in the subscriber list, no handle is allocated.
+    /// @tparam EventToBindInto The type of the event to bind to.
+    /// @tparam ClassToBind The type of the class containing the member function.
+    /// @tparam MemberFunction The const member function to bind.
+    /// @param instance A pointer to the instance of the class to bind.
+    template <typename EventToBindInto, typename ClassToBind, void(ClassToBind::* MemberFunction)(const EventToBindInto&) const>
+    void Bind(const ClassToBind* instance)
+    {
+        Delegate<void(const EventToBindInto&)> delegate;
+        delegate.template Bind<ClassToBind, MemberFunction>(instance);
+
+        GetChannel<EventToBindInto>().delegates.push_back(delegate);
+    }
+
+    /// @brief Binds a free function to an event. The delegate is stored by value in the subscriber list.
+    /// @tparam EventToBindInto The type of the event to bind to.
+    /// @tparam Function The free function to bind.
+    template <typename EventToBindInto, void(*Function)(const EventToBindInto&)>
+    void Bind()
+    {
+        Delegate<void(const EventToBindInto&)> delegate;
+        delegate.template Bind<Function>();
+
+        GetChannel<EventToBindInto>().delegates.push_back(delegate);
+    }
+
+    /// @brief Binds a captureless lambda to an event. The delegate is stored by value in the subscriber list
+    /// and calls the lambda directly.
+    /// @tparam EventToBindInto The type of the event to bind to.
+    /// @tparam Lambda The type of the lambda, deduced.
+    /// @param lambda The lambda to bind.
+    template <typename EventToBindInto, typename Lambda>
+    void Bind(const Lambda& lambda)
+    {
+        Delegate<void(const EventToBindInto&)> delegate;
+        delegate.Bind(lambda);
+
+        GetChannel<EventToBindInto>().delegates.push_back(delegate);
+    }
+
+    /// @brief Binds a member function through a SubscriptionNode embedded in the subscriber.
+    /// The node is linked into the bus's list for the event type without allocating (apart from creating the
+    /// list for the first subscriber of an event type) and unlinks itself in O(1) when destroyed.
+    /// A node can only be bound once; binding it again moves it.
+    /// @tparam EventToBindInto The type of the event to bind to.
+    /// @tparam ClassToBind The type of the class containing the member function.
+    /// @tparam MemberFunction The member function to bind.
+    /// @param instance A pointer to the instance of the class to bind.
+    /// @param node The node holding the subscription, usually a member of instance.
+    template <typename EventToBindInto, typename ClassToBind, void(ClassToBind::* MemberFunction)(const EventToBindInto&)>
+    void Bind(ClassToBind* instance, SubscriptionNode<EventToBindInto>& node)
+    {
+        node.m_delegate.template Bind<ClassToBind, MemberFunction>(instance);
+        GetEntry<EventToBindInto>()->second.nodes.PushBack(node);
+    }
+
+    /// @brief Returns the subscription group with the given name, creating it if needed.
+    /// @param name The name of the group.
+    /// @return A handle to the group, used to bind into it and to mute or resume it.
+    SubscriptionGroup GetGroup(const std::string& name)
+    {
+        auto it = m_groups.find(name);
+        if (it == m_groups.end())
+        {
+            const TrackingAllocator<SubscriptionGroupState> allocator(m_tracker.get(), AllocationCategory::Lists);
+            it = m_groups.emplace(name, SubscriptionGroup(std::allocate_shared<SubscriptionGroupState>(allocator, name))).first;
+        }
+        return it->second;
+    }
+
+    /// @brief Binds a member function of a specific class instance to an event as part of a subscription group.
+    /// Muting the group skips all of its subscribers with one check per event type; they stay bound.
+    /// @tparam EventToBindInto The type of the event to bind to.
+    /// @tparam ClassToBind The type of the class containing the member function.
+    /// @tparam MemberFunction The member function to bind.
+    /// @param instance A pointer to the instance of the class to bind.
+    /// @param group The group to bind into, obtained from GetGroup.
+    template <typename EventToBindInto, typename ClassToBind, void(ClassToBind::* MemberFunction)(const EventToBindInto&)>
+    void Bind(ClassToBind* instance, const SubscriptionGroup& group)
+    {
+        Delegate<void(const EventToBindInto&)> delegate;
+        delegate.template Bind<ClassToBind, MemberFunction>(instance);
+
+        GetChannel<EventToBindInto>().GroupDelegates(group.State()).push_back(delegate);
+    }
+
+    /// @brief Binds a member function of an object living inside a caller-supplied pool as an 8 byte CompactDelegate.
+    /// Compact subscribers are stored contiguously in the channel, which halves the subscriber table size
+    /// compared to Delegate and avoids the per subscriber handle allocation.
+    /// @tparam EventToBindInto The type of the event to bind to.
+    /// @tparam ClassToBind The type of the pooled objects.
+    /// @tparam MemberFunction The member function to bind.
+    /// @tparam Pool Any type whose operator[](std::uint32_t) returns a ClassToBind&. Has to outlive the binding.
+    /// @param pool The pool holding the instance.
+    /// @param instanceIndex The index of the instance inside the pool.
+    template <typename EventToBindInto, typename ClassToBind, void(ClassToBind::* MemberFunction)(const EventToBindInto&), typename Pool>
+    void BindCompact(Pool& pool, std::uint32_t instanceIndex)
+    {
+        CompactDelegate<void(const EventToBindInto&)> delegate;
+        delegate.template Bind<ClassToBind, MemberFunction>(pool, instanceIndex);
+
+        GetChannel<EventToBindInto>().compact.push_back(delegate);
+    }
+
+    /// @brief Unbinds a compact subscriber previously bound with BindCompact.
+    /// @tparam EventToUnbind The type of the event to unbind from.
+    /// @tparam ClassToUnbind The type of the pooled objects.
+    /// @tparam MemberFunction The member function to unbind.
+    /// @tparam Pool The pool type.
+    /// @param pool The pool holding the instance.
+    /// @param instanceIndex The index of the instance inside the pool.
+    template <typename EventToUnbind, typename ClassToUnbind, void(ClassToUnbind::* MemberFunction)(const EventToUnbind&), typename Pool>
+    void UnbindCompact(const Pool& pool, std::uint32_t instanceIndex)
+    {
+        const auto it = m_map.find(typeid(EventToUnbind));
+        if (it == m_map.end()) return; // No such event is bound
+
+        auto& compact = MakeUnique<EventToUnbind>(it).compact;
+        compact.erase(
+            std::remove_if(
+                compact.begin(),
+                compact.end(),
+                [&pool, instanceIndex](const CompactDelegate<void(const EventToUnbind&)>& delegate)
+                {
+                    return delegate.template Matches<ClassToUnbind, MemberFunction>(pool, instanceIndex);
+                }),
+            compact.end());
+
+        EraseIfEmpty(it);
     }
 
     /// @brief Unbinds a member function of a specific class instance from an event.
@@ -50,31 +614,419 @@ public:
         if (it == m_map.end()) return; // No such event is bound
 
         // Remove handles that match the instance and member function
-        it->second.erase(
+        auto& channel = MakeUnique<EventToUnbind>(it);
+        auto& handles = channel.handles;
+        handles.erase(
             std::remove_if(
-                it->second.begin(),
-                it->second.end(),
-                [instance](const std::unique_ptr<IDelegateHandle>& handle)
+                handles.begin(),
+                handles.end(),
+                [instance](const DelegateHandlePtr& handle)
                 {
-                    // Attempt to cast to Handle<EventToUnbind>
-                    auto* typedHandle = dynamic_cast<DelegateHandle<EventToUnbind>*>(handle.get());
-                    if (!typedHandle) return false;
+                    // The channel only ever holds handles of its own event type
+                    auto* typedHandle = static_cast<DelegateHandle<EventToUnbind>*>(handle.get());
 
                     // Check if the delegate matches the instance
-                    return typedHandle->Matches<ClassToUnbind, MemberFunction>(instance);
+                    return typedHandle->template Matches<ClassToUnbind, MemberFunction>(instance);
                 }),
-            it->second.end());
+            handles.end());
 
-        if (!it->second.empty()) 
+        // Subscriptions of the same member function made inside groups
+        channel.EraseDelegates([instance](const Delegate<void(const EventToUnbind&)>& delegate)
         {
-            m_map.erase(it);
+            return delegate.template Matches<ClassToUnbind, MemberFunction>(instance);
+        });
+
+        EraseIfEmpty(it);
+    }
+
+    /// @brief Unbinds a const member function of a specific class instance from an event.
+    /// @tparam EventToUnbind The type of the event to unbind from.
+    /// @tparam ClassToUnbind The type of the class containing the member function.
+    /// @tparam MemberFunction The const member function to unbind.
+    /// @param instance A pointer to the instance of the class to unbind.
+    template <typename EventToUnbind, typename ClassToUnbind, void (ClassToUnbind::* MemberFunction)(const EventToUnbind&) const>
+    void Unbind(const ClassToUnbind* instance)
+    {
+        UnbindDelegates<EventToUnbind>([instance](const Delegate<void(const EventToUnbind&)>& delegate)
+        {
+            return delegate.template Matches<ClassToUnbind, MemberFunction>(instance);
+        });
+    }
+
+    /// @brief Unbinds a free function from an event.
+    /// @tparam EventToUnbind The type of the event to unbind from.
+    /// @tparam Function The free function to unbind.
+    template <typename EventToUnbind, void(*Function)(const EventToUnbind&)>
+    void Unbind()
+    {
+        UnbindDelegates<EventToUnbind>([](const Delegate<void(const EventToUnbind&)>& delegate)
+        {
+            return delegate.template Matches<Function>();
+        });
+    }
+
+    /// @brief Unbinds every binding of a captureless lambda type from an event.
+    /// @tparam EventToUnbind The type of the event to unbind from.
+    /// @tparam Lambda The type of the lambda, deduced.
+    /// @param lambda The lambda to unbind.
+    template <typename EventToUnbind, typename Lambda>
+    void Unbind(const Lambda& lambda)
+    {
+        UnbindDelegates<EventToUnbind>([&lambda](const Delegate<void(const EventToUnbind&)>& delegate)
+        {
+            return delegate.Matches(lambda);
+        });
+    }
+
+    /// @brief Unbinds an intrusive subscription. Equivalent to SubscriptionNode::Unlink.
+    /// @tparam EventToUnbind The type of the event to unbind from.
+    /// @param node The node to unlink.
+    template <typename EventToUnbind>
+    void Unbind(SubscriptionNode<EventToUnbind>& node)
+    {
+        node.Unlink();
+    }
+
+    /// @brief Unbinds every subscription of a group, from all event types.
+    /// @param group The group whose subscriptions to remove. The group itself stays valid.
+    void UnbindGroup(const SubscriptionGroup& group)
+    {
+        for (auto it = m_map.begin(); it != m_map.end();)
+        {
+            if (!it->second.channel->HasGroup(group.State().get()))
+            {
+                ++it;
+                continue;
+            }
+
+            MakeUnique(it).EraseGroup(group.State().get());
+            it = EraseIfEmpty(it);
         }
     }
 
+    /// @brief Unbinds every subscription, of every event type, whose instance matches a predicate.
+    /// Each subscriber list is compacted in a single linear pass, so the whole call is O(total subscriptions).
+    /// Member function subscriptions are passed their instance, compact subscriptions the address of their pooled instance
+    /// and free functions nullptr. Captureless lambdas are passed the address of the copy shared by every delegate of
+    /// that lambda type (see Delegate::Bind), which never lies inside a caller's objects.
+    /// @tparam Predicate A callable taking the instance (const void*) and returning true for subscriptions to remove.
+    /// @param predicate The predicate.
+    /// @return The number of removed subscriptions.
+    template <typename Predicate>
+    std::size_t UnbindIf(const Predicate& predicate)
+    {
+        const InstancePredicate test(predicate);
+        std::size_t removed = 0;
+
+        for (auto it = m_map.begin(); it != m_map.end();)
+        {
+            removed += it->second.channel->UnlinkInstances(it->second.nodes, test);
+
+            // Do not copy a channel shared with a fork unless something has to be removed from it
+            if (it->second.channel.use_count() == 1 || it->second.channel->AnyInstance(test))
+            {
+                removed += MakeUnique(it).EraseInstances(test);
+            }
+            it = EraseIfEmpty(it);
+        }
+        return removed;
+    }
+
+    /// @brief Unbinds every subscription whose instance lies in [instanceBegin, instanceEnd), e.g. inside an arena.
+    /// @param instanceBegin The first address of the range.
+    /// @param instanceEnd The address one past the end of the range.
+    /// @return The number of removed subscriptions.
+    std::size_t UnbindRange(const void* instanceBegin, const void* instanceEnd)
+    {
+        return UnbindIf([instanceBegin, instanceEnd](const void* instance)
+        {
+            const std::less<const void*> less;
+            return instance != nullptr && !less(instance, instanceBegin) && less(instance, instanceEnd);
+        });
+    }
+
+    /// @brief Returns the memory accounting of this bus: current/peak bytes and allocation counts in total,
+    /// per internal structure (AllocationCategory) and per event type (AllocationTracker::ForType).
+    const AllocationTracker& GetAllocationStats() const
+    {
+        return *m_tracker;
+    }
+
 private:
-    /// @brief A map that associates event types with a list of delegate handles.
-	/// Each event type (key) maps to a vector of unique pointers to delegate handles.
-    std::unordered_map<std::type_index, std::vector<std::unique_ptr<IDelegateHandle>>> m_map;
-};
+    struct ChannelEntry;
+    struct HierarchyNode;
+
+    /// @brief Filter of a forwarding rule, a bool(*)(const Event&) stored without its event type.
+    using ErasedFilter = void(*)();
+
+    /// @brief Resolved forwarding rule: emitting on the owning entry continues on the target entry.
+    struct ForwardLink
+    {
+        ChannelEntry* target = nullptr;            ///< The entry of the same event type in the other bus.
+        const HierarchyNode* targetBus = nullptr;  ///< The bus owning the target entry.
+        ErasedFilter filter = nullptr;             ///< Events the filter rejects are not forwarded.
+    };
+
+    using ForwardLinkList = std::vector<ForwardLink, TrackingAllocator<ForwardLink>>;
+    using SourceList = std::vector<ChannelEntry*, TrackingAllocator<ChannelEntry*>>;
+
+    /// @brief Everything the bus keeps for one event type.
+    struct ChannelEntry
+    {
+        ChannelEntry(EventChannelPtr sharedChannel, AllocationTracker* tracker, AllocationCounters* typeCounters)
+            : channel(std::move(sharedChannel)),
+              forwards(TrackingAllocator<ForwardLink>(tracker, AllocationCategory::Lists, typeCounters)),
+              sources(TrackingAllocator<ChannelEntry*>(tracker, AllocationCategory::Lists, typeCounters)) {}
+
+        EventChannelPtr channel;       ///< Subscriber lists, shared copy-on-write with forked buses.
+        IntrusiveSubscriberList nodes; ///< Intrusive subscribers. Lives inside the map node, so its address is stable.
+        ForwardLinkList forwards;      ///< Entries of related buses every emit continues to.
+        SourceList sources;            ///< Entries of related buses forwarding to this one; keep the entry alive.
+    };
+
+    /// @brief Creates the forwarding link of one event type between two related buses.
+    using LinkFunction = void(*)(SignalBus& from, SignalBus& to, ErasedFilter filter);
+
+    /// @brief Forwarding rule as set by the user, re-applied whenever the relationship it refers to changes.
+    struct ForwardRule
+    {
+        std::type_index type;
+        ErasedFilter filter;
+        LinkFunction link;
+    };
+
+    /// @brief Position of a bus in the hierarchy. Heap allocated so relatives keep a stable address when the bus is moved.
+    struct HierarchyNode
+    {
+        explicit HierarchyNode(SignalBus* owner)
+            : bus(owner) {}
+
+        SignalBus* bus;                        ///< The bus currently owning this node.
+        HierarchyNode* parent = nullptr;
+        std::vector<HierarchyNode*> children;
+        std::vector<ForwardRule> parentRules;  ///< Event types forwarded to the parent.
+        std::vector<ForwardRule> childRules;   ///< Event types forwarded to the children.
+    };
+
+    using MapAllocator = TrackingAllocator<std::pair<const std::type_index, ChannelEntry>>;
+    using GroupMapAllocator = TrackingAllocator<std::pair<const std::string, SubscriptionGroup>>;
+    using Map = std::unordered_map<std::type_index, ChannelEntry, std::hash<std::type_index>, std::equal_to<std::type_index>, MapAllocator>;
+
+    /// @brief Returns the channel of an event type for modification, creating it with an accounted allocator if needed.
+    template <typename Event>
+    EventChannel<Event>& GetChannel()
+    {
+        return MakeUnique<Event>(GetEntry<Event>());
+    }
+
+    /// @brief Returns the map entry of an event type, creating it together with an empty channel if needed.
+    template <typename Event>
+    Map::iterator GetEntry()
+    {
+        auto it = m_map.find(typeid(Event));
+        if (it == m_map.end())
+        {
+            AllocationCounters* typeCounters = &m_tracker->TypeCounters(typeid(Event));
+            auto channel = EventChannel<Event>::Create(m_tracker.get(), typeCounters);
+            it = m_map.try_emplace(typeid(Event), std::move(channel), m_tracker.get(), typeCounters).first;
+        }
+        return it;
+    }
+
+    /// @brief Copies the channel the iterator points to if it is shared with a forked bus, so it can be modified.
+    IEventChannel& MakeUnique(Map::iterator it)
+    {
+        if (it->second.channel.use_count() > 1)
+        {
+            it->second.channel = it->second.channel->CloneChannel(m_tracker.get(), &m_tracker->TypeCounters(it->first));
+        }
+        else
+        {
+            // Pairs with the release of the last other owner, its reads of the channel are complete
+            std::atomic_thread_fence(std::memory_order_acquire);
+        }
+        return *it->second.channel;
+    }
+
+    /// @brief Typed version of MakeUnique.
+    template <typename Event>
+    EventChannel<Event>& MakeUnique(Map::iterator it)
+    {
+        return static_cast<EventChannel<Event>&>(MakeUnique(it));
+    }
+
+    /// @brief Makes room for count more elements, growing geometrically so repeated bulk binds stay amortized linear.
+    template <typename List>
+    static void ReserveAdditional(List& list, std::size_t count)
+    {
+        const std::size_t required = list.size() + count;
+        if (required > list.capacity())
+        {
+            list.reserve(std::max(required, list.capacity() * 2));
+        }
+    }
+
+    /// @brief Removes by-value delegates of an event type that match a predicate, grouped ones included.
+    template <typename Event, typename Predicate>
+    void UnbindDelegates(Predicate predicate)
+    {
+        const auto it = m_map.find(typeid(Event));
+        if (it == m_map.end()) return; // No such event is bound
+
+        MakeUnique<Event>(it).EraseDelegates(predicate);
+
+        EraseIfEmpty(it);
+    }
+
+    /// @brief Removes the entry the iterator points to if it has no subscribers left and no forwarding links.
+    /// @return The iterator following the entry.
+    Map::iterator EraseIfEmpty(Map::iterator it)
+    {
+        const ChannelEntry& entry = it->second;
+        if (entry.channel->Empty() && entry.nodes.Empty() && entry.forwards.empty() && entry.sources.empty())
+        {
+            return m_map.erase(it);
+        }
+        return std::next(it);
+    }
+
+    /// @brief Delivers an event to the subscribers of an entry, then follows its forwarding links.
+    template <typename Event>
+    static void EmitEntry(const ChannelEntry& entry, const Event& data)
+    {
+        static_cast<const EventChannel<Event>*>(entry.channel.get())->Emit(data);
+        entry.nodes.Emit(data);
+
+        for (const ForwardLink& link : entry.forwards)
+        {
+            if (link.filter == nullptr || reinterpret_cast<bool(*)(const Event&)>(link.filter)(data))
+            {
+                EmitEntry(*link.target, data);
+            }
+        }
+    }
+
+    template <typename Event>
+    static void DispatchQueued(void* bus, const void* event)
+    {
+        static_cast<SignalBus*>(bus)->Emit(*static_cast<const Event*>(event));
+    }
+
+    HierarchyNode& Hierarchy()
+    {
+        if (m_hierarchy == nullptr)
+        {
+            m_hierarchy = std::make_unique<HierarchyNode>(this);
+        }
+        return *m_hierarchy;
+    }
+
+    /// @brief Checks whether following the forwarding links from an entry ever reaches another entry.
+    static bool Reaches(const ChannelEntry& from, const ChannelEntry* goal)
+    {
+        if (&from == goal) return true;
+        for (const ForwardLink& link : from.forwards)
+        {
+            if (Reaches(*link.target, goal)) return true;
+        }
+        return false;
+    }
+
+    /// @brief Resolves a forwarding rule of one event type between two related buses.
+    template <typename Event>
+    static void Link(SignalBus& from, SignalBus& to, ErasedFilter filter)
+    {
+        const auto source = from.GetEntry<Event>();
+        const auto target = to.GetEntry<Event>();
+        if (Reaches(target->second, &source->second))
+        {
+            from.EraseIfEmpty(source);
+            to.EraseIfEmpty(target);
+            throw ForwardingCycle();
+        }
+
+        source->second.forwards.push_back(ForwardLink{ &target->second, to.m_hierarchy.get(), filter });
+        target->second.sources.push_back(&source->second);
+    }
+
+    /// @brief Removes the forwarding links of one event type from a bus to a related bus.
+    static void RemoveLinks(SignalBus& from, const HierarchyNode& to, std::type_index type)
+    {
+        const auto source = from.m_map.find(type);
+        if (source == from.m_map.end()) return;
+
+        auto& forwards = source->second.forwards;
+        const auto linked = std::find_if(forwards.begin(), forwards.end(), [&to](const ForwardLink& link) { return link.targetBus == &to; });
+        if (linked == forwards.end()) return;
+
+        auto& sources = linked->target->sources;
+        sources.erase(std::find(sources.begin(), sources.end(), &source->second));
+        forwards.erase(linked);
+
+        to.bus->EraseIfEmpty(to.bus->m_map.find(type));
+        from.EraseIfEmpty(source);
+    }
+
+    /// @brief Removes every forwarding link between two buses, in both directions.
+    static void RemoveAllLinks(SignalBus& first, SignalBus& second)
+    {
+        for (const ForwardRule& rule : first.m_hierarchy->parentRules)
+        {
+            RemoveLinks(first, *second.m_hierarchy, rule.type);
+        }
+        for (const ForwardRule& rule : first.m_hierarchy->childRules)
+        {
+            RemoveLinks(first, *second.m_hierarchy, rule.type);
+        }
+        for (const ForwardRule& rule : second.m_hierarchy->parentRules)
+        {
+            RemoveLinks(second, *first.m_hierarchy, rule.type);
+        }
+        for (const ForwardRule& rule : second.m_hierarchy->childRules)
+        {
+            RemoveLinks(second, *first.m_hierarchy, rule.type);
+        }
+    }
+
+    /// @brief Ends the relationship between a parent and one of its children.
+    static void Detach(SignalBus& parent, SignalBus& child)
+    {
+        RemoveAllLinks(parent, child);
+
+        auto& children = parent.m_hierarchy->children;
+        children.erase(std::find(children.begin(), children.end(), child.m_hierarchy.get()));
+        child.m_hierarchy->parent = nullptr;
+    }
+
+    static void EraseRule(std::vector<ForwardRule>& rules, std::type_index type)
+    {
+        rules.erase(
+            std::remove_if(rules.begin(), rules.end(), [type](const ForwardRule& rule) { return rule.type == type; }),
+            rules.end());
+    }
+
+    /// @brief Accounting of every allocation made by the bus. Shared so that allocators stay valid when the bus is moved.
+    std::shared_ptr<AllocationTracker> m_tracker;
+
+    /// @brief Trackers of the buses this one was forked from. Channels shared with them report to these trackers,
+    /// so they have to outlive the map.
+    std::vector<std::shared_ptr<AllocationTracker>> m_sharedTrackers;
+
+    /// @brief A map that associates event types with the channel holding their subscribers.
+    Map m_map;
+
+    /// @brief Subscription groups by name.
+    std::unordered_map<std::string, SubscriptionGroup, std::hash<std::string>, std::equal_to<std::string>, GroupMapAllocator> m_groups;
+
+    /// @brief Parent, children and forwarding rules. Only allocated once the bus takes part in a hierarchy.
+    std::unique_ptr<HierarchyNode> m_hierarchy;
+
+    /// @brief Events deferred with Enqueue. Declared last, so queued events are destroyed while the bus is still complete.
+    EventQueue m_queue;
 
+    /// @brief Receives a record of every emit, if set.
+    FlightRecorder* m_recorder = nullptr;
 
+    /// @brief Receives the counters of every emit, if set.
+    LiveStatistics* m_statistics = nullptr;
+};
\ No newline at end of file
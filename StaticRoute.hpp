@@ -0,0 +1,111 @@
+#pragma once
+#include <cstddef>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "SignalBus.hpp"
+
+/// @brief Describes a handler usable in a StaticRoute: which instance it needs and how to call it.
+/// @tparam Handler The type of the handler (member function pointer or function pointer).
+template <typename Handler>
+struct StaticHandlerTraits;
+
+template <typename Class, typename Event>
+struct StaticHandlerTraits<void(Class::*)(const Event&)>
+{
+	using EventType = Event;
+	using Instance = Class*;
+
+	template <void(Class::* Handler)(const Event&)>
+	static void Invoke(Instance instance, const Event& event)
+	{
+		(instance->*Handler)(event);
+	}
+};
+
+template <typename Class, typename Event>
+struct StaticHandlerTraits<void(Class::*)(const Event&) const>
+{
+	using EventType = Event;
+	using Instance = const Class*;
+
+	template <void(Class::* Handler)(const Event&) const>
+	static void Invoke(Instance instance, const Event& event)
+	{
+		(instance->*Handler)(event);
+	}
+};
+
+template <typename Event>
+struct StaticHandlerTraits<void(*)(const Event&)>
+{
+	using EventType = Event;
+	using Instance = std::nullptr_t; ///< Free functions take no instance; pass nullptr in their slot.
+
+	template <void(*Handler)(const Event&)>
+	static void Invoke(Instance /* unused */, const Event& event)
+	{
+		(*Handler)(event);
+	}
+};
+
+/// @brief Compile-time wiring of an event to a fixed list of handlers. Handlers are template arguments,
+/// so emitting compiles to direct calls the compiler can inline, without type erasure or stubs.
+/// Subscribers that change at runtime stay on an attached SignalBus, which Emit forwards to after the
+/// static handlers. The route can also be bound into a bus itself (through Dispatch) to make its static
+/// handlers part of that bus's dynamic emits.
+/// @tparam Event The type of the event.
+/// @tparam Handlers Member functions (const or not) or free functions taking const Event&, called in order.
+template <typename Event, auto... Handlers>
+class StaticRoute
+{
+	static_assert((std::is_same_v<typename StaticHandlerTraits<decltype(Handlers)>::EventType, Event> && ...),
+		"Every handler of a static route has to take the route's event type");
+
+public:
+	/// @brief Creates the route.
+	/// @param instances One instance per handler, in the order of the handlers; nullptr for free functions.
+	explicit StaticRoute(typename StaticHandlerTraits<decltype(Handlers)>::Instance... instances)
+		: m_instances(instances...) {}
+
+	/// @brief Creates the route and attaches a bus for the dynamic subscribers.
+	/// @param bus The bus Emit forwards to after the static handlers.
+	/// @param instances One instance per handler, in the order of the handlers; nullptr for free functions.
+	explicit StaticRoute(SignalBus& bus, typename StaticHandlerTraits<decltype(Handlers)>::Instance... instances)
+		: m_instances(instances...), m_bus(&bus) {}
+
+	/// @brief Calls the static handlers, then emits on the attached bus, if any.
+	/// @param event The event to deliver.
+	void Emit(const Event& event) const
+	{
+		Dispatch(event);
+		if (m_bus != nullptr)
+		{
+			m_bus->Emit<Event>(event);
+		}
+	}
+
+	/// @brief Calls only the static handlers. Can be bound into a SignalBus as a regular const member function.
+	/// @param event The event to deliver.
+	void Dispatch(const Event& event) const
+	{
+		DispatchAll(event, std::index_sequence_for<decltype(Handlers)...>{});
+	}
+
+	/// @brief Attaches (or with nullptr detaches) the bus for the dynamic subscribers.
+	void AttachBus(SignalBus* bus)
+	{
+		m_bus = bus;
+	}
+
+private:
+	template <std::size_t... Indices>
+	void DispatchAll(const Event& event, std::index_sequence<Indices...>) const
+	{
+		(StaticHandlerTraits<decltype(Handlers)>::template Invoke<Handlers>(std::get<Indices>(m_instances), event), ...);
+	}
+
+	std::tuple<typename StaticHandlerTraits<decltype(Handlers)>::Instance...> m_instances; ///< Instances of the handlers.
+	SignalBus* m_bus = nullptr; ///< Bus of the dynamic subscribers, if any.
+};
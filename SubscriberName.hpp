@@ -0,0 +1,117 @@
+#pragma once
+#include <algorithm>
+#include <mutex>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+/// @brief Set to 0 to leave subscriber names out of the binary. Names cost nothing when binding or emitting,
+/// they are registered during static initialization, once per bound function.
+#ifndef SIGNALBUS_SUBSCRIBER_NAMES
+#define SIGNALBUS_SUBSCRIBER_NAMES 1
+#endif
+
+/// @brief Extracts the text between the given prefix and the end of the template argument list
+/// from a compiler-generated function signature.
+constexpr std::string_view ExtractSubscriberName(std::string_view signature, std::string_view prefix, std::string_view suffix)
+{
+	const std::size_t begin = signature.find(prefix);
+	if (begin == std::string_view::npos) return {};
+
+	std::string_view name = signature.substr(begin + prefix.size());
+	const std::size_t end = name.find_first_of(suffix);
+	name = name.substr(0, end);
+	if (!name.empty() && name.front() == '&')
+	{
+		name.remove_prefix(1);
+	}
+	return name;
+}
+
+/// @brief Returns the qualified name of a function, e.g. "Player::OnDamage", computed at compile time.
+/// @tparam Function A pointer to a free or member function.
+template <auto Function>
+constexpr std::string_view SubscriberNameOf()
+{
+#if defined(__clang__) || defined(__GNUC__)
+	return ExtractSubscriberName(__PRETTY_FUNCTION__, "Function = ", ";]");
+#elif defined(_MSC_VER)
+	return ExtractSubscriberName(__FUNCSIG__, "SubscriberNameOf<", ">");
+#else
+	return {};
+#endif
+}
+
+/// @brief Returns the name of a type, computed at compile time. Used to name lambda subscribers.
+/// @tparam T The type to name.
+template <typename T>
+constexpr std::string_view SubscriberTypeNameOf()
+{
+#if defined(__clang__) || defined(__GNUC__)
+	return ExtractSubscriberName(__PRETTY_FUNCTION__, "T = ", ";]");
+#elif defined(_MSC_VER)
+	return ExtractSubscriberName(__FUNCSIG__, "SubscriberTypeNameOf<", ">");
+#else
+	return {};
+#endif
+}
+
+/// @brief Global lookup from the stub address of a delegate (Delegate::StubAddress) to the name of the
+/// function it calls. Every stub is a separate template instantiation per bound function, so the stub
+/// identifies the subscriber; instrumentation looks the name up off the emit path.
+class SubscriberNames
+{
+public:
+	/// @brief Returns the name of the function a stub calls, or an empty view if it is unknown.
+	static std::string_view Find(const void* stub)
+	{
+		Registry& registry = Instance();
+		std::lock_guard<std::mutex> lock(registry.mutex);
+		const auto it = std::find_if(registry.names.begin(), registry.names.end(),
+			[stub](const std::pair<const void*, std::string_view>& entry) { return entry.first == stub; });
+		return it != registry.names.end() ? it->second : std::string_view();
+	}
+
+	/// @brief Makes a stub's name available to Find. Expands to nothing at runtime: the name is
+	/// registered by the static initializer of a per-stub variable, instantiated by this call.
+	/// @tparam Stub The stub function of a delegate.
+	/// @tparam Name Returns the name of the function the stub calls.
+	template <auto Stub, std::string_view(*Name)()>
+	static void Declare()
+	{
+#if SIGNALBUS_SUBSCRIBER_NAMES
+		static_cast<void>(&Registration<Stub, Name>::registered);
+#endif
+	}
+
+private:
+	struct Registry
+	{
+		std::mutex mutex;
+		std::vector<std::pair<const void*, std::string_view>> names;
+	};
+
+	template <auto Stub, std::string_view(*Name)()>
+	struct Registration
+	{
+		static const bool registered;
+	};
+
+	static Registry& Instance()
+	{
+		static Registry registry;
+		return registry;
+	}
+
+	static bool Register(const void* stub, std::string_view name)
+	{
+		Registry& registry = Instance();
+		std::lock_guard<std::mutex> lock(registry.mutex);
+		registry.names.emplace_back(stub, name);
+		return true;
+	}
+};
+
+template <auto Stub, std::string_view(*Name)()>
+const bool SubscriberNames::Registration<Stub, Name>::registered =
+	SubscriberNames::Register(reinterpret_cast<const void*>(Stub), Name());
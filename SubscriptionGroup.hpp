@@ -0,0 +1,64 @@
+#pragma once
+#include <atomic>
+#include <memory>
+#include <string>
+#include <utility>
+
+/// @brief Shared state of a subscription group.
+struct SubscriptionGroupState
+{
+	explicit SubscriptionGroupState(std::string groupName)
+		: name(std::move(groupName)) {}
+
+	std::string name;                ///< The name the group was created with.
+	std::atomic<bool> muted{ false }; ///< Whether subscribers of the group are skipped by emits. May be flipped while another thread emits.
+};
+
+/// @brief Named set of subscriptions that can be muted and resumed as a whole in O(1).
+/// Subscribers of a group are stored together in every event type's channel, so an emit skips
+/// a muted group with a single check instead of checking each subscriber.
+/// The handle is cheap to copy; all copies refer to the same group. A forked bus has its own copies of the groups.
+class SubscriptionGroup
+{
+public:
+	SubscriptionGroup() = default;
+
+	explicit SubscriptionGroup(std::shared_ptr<SubscriptionGroupState> state)
+		: m_state(std::move(state)) {}
+
+	/// @brief Stops delivering events to every subscriber of the group, without unbinding them.
+	void Mute()
+	{
+		m_state->muted.store(true, std::memory_order_relaxed);
+	}
+
+	/// @brief Delivers events to the subscribers of the group again.
+	void Resume()
+	{
+		m_state->muted.store(false, std::memory_order_relaxed);
+	}
+
+	bool IsMuted() const
+	{
+		return m_state->muted.load(std::memory_order_relaxed);
+	}
+
+	const std::string& Name() const
+	{
+		return m_state->name;
+	}
+
+	/// @brief Checks whether the handle refers to a group.
+	bool IsValid() const
+	{
+		return m_state != nullptr;
+	}
+
+	const std::shared_ptr<SubscriptionGroupState>& State() const
+	{
+		return m_state;
+	}
+
+private:
+	std::shared_ptr<SubscriptionGroupState> m_state;
+};
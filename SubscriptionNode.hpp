@@ -0,0 +1,191 @@
+#pragma once
+#include <cstddef>
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <xmmintrin.h>
+#endif
+
+#include "Delegate.hpp"
+#include "HandlerActivity.hpp"
+
+class SignalBus;
+class IntrusiveSubscriberList;
+
+/// @brief Hints the CPU to start loading a cache line that is about to be read.
+inline void PrefetchForRead(const void* address)
+{
+#if defined(__GNUC__) || defined(__clang__)
+	__builtin_prefetch(address, 0, 3);
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+	_mm_prefetch(static_cast<const char*>(address), _MM_HINT_T0);
+#else
+	(void)address;
+#endif
+}
+
+/// @brief Untyped part of a subscription node: the links of the intrusive list.
+class SubscriptionNodeBase
+{
+public:
+	SubscriptionNodeBase() = default;
+	SubscriptionNodeBase(const SubscriptionNodeBase&) = delete;
+	auto operator=(const SubscriptionNodeBase&)->SubscriptionNodeBase & = delete;
+
+	/// @brief Checks whether the node is currently bound to a bus.
+	bool IsLinked() const
+	{
+		return m_list != nullptr;
+	}
+
+	/// @brief Removes the node from the list it is linked into, in O(1). Does nothing if it is not linked.
+	inline void Unlink();
+
+protected:
+	~SubscriptionNodeBase()
+	{
+		Unlink();
+	}
+
+private:
+	friend class IntrusiveSubscriberList;
+
+	IntrusiveSubscriberList* m_list = nullptr; ///< The list the node is linked into, if any.
+	SubscriptionNodeBase* m_previous = nullptr;
+	SubscriptionNodeBase* m_next = nullptr;
+};
+
+/// @brief Subscription embedded in the subscriber object itself. Binding it to a bus links it into the
+/// bus's list for the event type without allocating; destroying it unlinks it in O(1).
+/// A handler may unlink its own node while being dispatched, but not other nodes of the same event type.
+/// @tparam T The type of the event.
+template <typename T>
+class SubscriptionNode : public SubscriptionNodeBase
+{
+public:
+	SubscriptionNode() = default;
+	~SubscriptionNode() = default;
+
+private:
+	friend class SignalBus;
+	friend class IntrusiveSubscriberList;
+
+	Delegate<void(const T&)> m_delegate; ///< The subscriber to invoke.
+};
+
+/// @brief Doubly linked list of subscription nodes of a single event type.
+/// Lives at a stable address inside the signal bus; nodes still linked when it is destroyed are detached.
+class IntrusiveSubscriberList
+{
+public:
+	IntrusiveSubscriberList() = default;
+	IntrusiveSubscriberList(const IntrusiveSubscriberList&) = delete;
+	auto operator=(const IntrusiveSubscriberList&)->IntrusiveSubscriberList & = delete;
+
+	~IntrusiveSubscriberList()
+	{
+		while (m_head != nullptr)
+		{
+			m_head->Unlink();
+		}
+	}
+
+	bool Empty() const
+	{
+		return m_head == nullptr;
+	}
+
+	/// @brief Appends a node, unlinking it from its previous list first.
+	void PushBack(SubscriptionNodeBase& node)
+	{
+		node.Unlink();
+		node.m_list = this;
+		node.m_previous = m_tail;
+		node.m_next = nullptr;
+		if (m_tail != nullptr)
+		{
+			m_tail->m_next = &node;
+		}
+		else
+		{
+			m_head = &node;
+		}
+		m_tail = &node;
+	}
+
+	/// @brief Invokes the delegates of all nodes, prefetching the next node while the current handler runs.
+	/// @tparam T The event type of the nodes in this list.
+	/// @param event The event to pass to the subscribers.
+	template <typename T>
+	void Emit(const T& event) const
+	{
+		SubscriptionNodeBase* node = m_head;
+		while (node != nullptr)
+		{
+			SubscriptionNodeBase* next = node->m_next;
+			if (next != nullptr)
+			{
+				PrefetchForRead(next);
+			}
+			InvokeHandler(static_cast<SubscriptionNode<T>*>(node)->m_delegate, event);
+			node = next;
+		}
+	}
+
+	/// @brief Unlinks every node whose subscriber instance matches a predicate, in one pass.
+	/// @tparam T The event type of the nodes in this list.
+	/// @param predicate Called with the instance each node's delegate is bound to.
+	/// @return The number of unlinked nodes.
+	template <typename T, typename Predicate>
+	std::size_t UnlinkIf(const Predicate& predicate)
+	{
+		std::size_t removed = 0;
+		SubscriptionNodeBase* node = m_head;
+		while (node != nullptr)
+		{
+			SubscriptionNodeBase* next = node->m_next;
+			if (predicate(static_cast<SubscriptionNode<T>*>(node)->m_delegate.Instance()))
+			{
+				Remove(*node);
+				++removed;
+			}
+			node = next;
+		}
+		return removed;
+	}
+
+private:
+	friend class SubscriptionNodeBase;
+
+	void Remove(SubscriptionNodeBase& node)
+	{
+		if (node.m_previous != nullptr)
+		{
+			node.m_previous->m_next = node.m_next;
+		}
+		else
+		{
+			m_head = node.m_next;
+		}
+		if (node.m_next != nullptr)
+		{
+			node.m_next->m_previous = node.m_previous;
+		}
+		else
+		{
+			m_tail = node.m_previous;
+		}
+		node.m_list = nullptr;
+		node.m_previous = nullptr;
+		node.m_next = nullptr;
+	}
+
+	SubscriptionNodeBase* m_head = nullptr;
+	SubscriptionNodeBase* m_tail = nullptr;
+};
+
+inline void SubscriptionNodeBase::Unlink()
+{
+	if (m_list != nullptr)
+	{
+		m_list->Remove(*this);
+	}
+}
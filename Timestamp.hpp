@@ -0,0 +1,47 @@
+#pragma once
+#include <chrono>
+#include <cstdint>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#elif defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+/// @brief Reads a cheap, monotonic tick counter: the TSC on x86, the virtual counter on ARM64,
+/// steady_clock nanoseconds elsewhere. Convert differences with TicksToNanoseconds.
+inline std::uint64_t ReadTimestamp()
+{
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+	return __rdtsc();
+#elif defined(__x86_64__) || defined(__i386__)
+	return __rdtsc();
+#elif defined(__aarch64__)
+	std::uint64_t ticks;
+	asm volatile("mrs %0, cntvct_el0" : "=r"(ticks));
+	return ticks;
+#else
+	return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+		std::chrono::steady_clock::now().time_since_epoch()).count());
+#endif
+}
+
+/// @brief Returns the number of ReadTimestamp ticks per nanosecond, measured against steady_clock
+/// on the first call (which takes about a millisecond).
+inline double TimestampTicksPerNanosecond()
+{
+	static const double ticksPerNanosecond = []
+	{
+		const auto start = std::chrono::steady_clock::now();
+		const std::uint64_t startTicks = ReadTimestamp();
+		while (std::chrono::steady_clock::now() - start < std::chrono::milliseconds(1)) {}
+		const auto elapsed = std::chrono::steady_clock::now() - start;
+		const std::uint64_t ticks = ReadTimestamp() - startTicks;
+		return static_cast<double>(ticks) / static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+	}();
+	return ticksPerNanosecond;
+}
+
+inline std::chrono::nanoseconds TicksToNanoseconds(std::uint64_t ticks)
+{
+	return std::chrono::nanoseconds(static_cast<std::int64_t>(static_cast<double>(ticks) / TimestampTicksPerNanosecond()));
+}
@@ -0,0 +1,245 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "Delegate.hpp"
+#include "LockFreeQueue.hpp"
+
+/// @brief How WorkQueue picks the worker a submitted job is queued for.
+enum class WorkerSelection
+{
+	RoundRobin, ///< Cycle through the workers.
+	LeastLoaded ///< The worker with the fewest queued jobs.
+};
+
+/// @brief Competing-consumer delivery: every submitted job is handled by exactly one of the bound workers,
+/// instead of being broadcast to all of them like SignalBus::Emit does.
+/// Every worker runs on its own thread and owns a lock-free queue; a worker whose queue is empty steals
+/// from the others. The queue can be bound into a SignalBus through Post to turn an event type into jobs.
+/// Handlers must not throw.
+/// @tparam Job The type of the jobs. Has to be default constructible and movable.
+template <typename Job>
+class WorkQueue
+{
+public:
+	/// @brief Creates the queue. Workers are added with AddWorker before calling Start.
+	/// @param selection How jobs are distributed between the workers.
+	/// @param capacityPerWorker The capacity of each worker's queue.
+	explicit WorkQueue(WorkerSelection selection = WorkerSelection::RoundRobin, std::size_t capacityPerWorker = 1024)
+		: m_selection(selection), m_capacityPerWorker(capacityPerWorker) {}
+
+	WorkQueue(const WorkQueue&) = delete;
+	auto operator=(const WorkQueue&)->WorkQueue & = delete;
+
+	~WorkQueue()
+	{
+		Stop();
+	}
+
+	/// @brief Adds a worker subscriber. Has to be called before Start.
+	/// @tparam Class The class type of the worker.
+	/// @tparam MemberFunction The member function handling a job.
+	/// @param instance The worker instance.
+	template <typename Class, void(Class::* MemberFunction)(const Job&)>
+	void AddWorker(Class* instance)
+	{
+		auto worker = std::make_unique<Worker>(m_capacityPerWorker);
+		worker->handler.template Bind<Class, MemberFunction>(instance);
+		m_workers.push_back(std::move(worker));
+	}
+
+	/// @brief Starts one thread per worker. Does nothing while the workers already run; after Stop it starts them again.
+	void Start()
+	{
+		if (!m_workers.empty() && m_workers.front()->thread.joinable()) return;
+
+		m_stopping.store(false, std::memory_order_relaxed);
+		for (std::size_t i = 0; i < m_workers.size(); ++i)
+		{
+			m_workers[i]->thread = std::thread([this, i] { Run(i); });
+		}
+	}
+
+	/// @brief Lets the workers finish every queued job, then joins their threads.
+	void Stop()
+	{
+		m_stopping.store(true, std::memory_order_release);
+		WakeAll();
+		for (auto& worker : m_workers)
+		{
+			if (worker->thread.joinable())
+			{
+				worker->thread.join();
+			}
+		}
+	}
+
+	/// @brief Queues a job for exactly one worker.
+	/// @param job The job.
+	/// @return False if every worker's queue is full (or there are no workers); the job is not queued then.
+	bool TrySubmit(Job job)
+	{
+		return TryQueue(job);
+	}
+
+	/// @brief Queues a job for exactly one worker, yielding while every queue is full.
+	/// @param job The job.
+	void Submit(Job job)
+	{
+		while (!TryQueue(job))
+		{
+			std::this_thread::yield();
+		}
+	}
+
+	/// @brief Queues a copy of the job. Matches the SignalBus subscriber signature, so a bus can feed the queue:
+	/// bus.Bind<Job, WorkQueue<Job>, &WorkQueue<Job>::Post>(&queue).
+	void Post(const Job& job)
+	{
+		Submit(job);
+	}
+
+	/// @brief Returns the number of jobs a worker has handled, stolen ones included.
+	std::size_t Processed(std::size_t workerIndex) const
+	{
+		return m_workers[workerIndex]->processed.load(std::memory_order_relaxed);
+	}
+
+	std::size_t WorkerCount() const
+	{
+		return m_workers.size();
+	}
+
+private:
+	struct Worker
+	{
+		explicit Worker(std::size_t capacity)
+			: queue(capacity) {}
+
+		Delegate<void(const Job&)> handler;
+		BoundedMpmcQueue<Job> queue;
+		std::atomic<std::size_t> processed{ 0 };
+		std::thread thread;
+	};
+
+	/// @brief Pushes the job to the selected worker, or to the next one with room. Moves from job only on success.
+	bool TryQueue(Job& job)
+	{
+		const std::size_t count = m_workers.size();
+		if (count == 0) return false;
+
+		const std::size_t first = SelectWorker();
+		for (std::size_t i = 0; i < count; ++i)
+		{
+			Worker& worker = *m_workers[(first + i) % count];
+			if (worker.queue.TryPush(job))
+			{
+				// Pairs with Sleep: either the sleeper sees the new count, or this sees the sleeper
+				m_submissions.fetch_add(1, std::memory_order_seq_cst);
+				if (m_sleepers.load(std::memory_order_seq_cst) > 0)
+				{
+					std::lock_guard<std::mutex> lock(m_sleepMutex);
+					m_wake.notify_one();
+				}
+				return true;
+			}
+		}
+		return false;
+	}
+
+	std::size_t SelectWorker()
+	{
+		if (m_selection == WorkerSelection::RoundRobin)
+		{
+			return m_nextWorker.fetch_add(1, std::memory_order_relaxed) % m_workers.size();
+		}
+
+		std::size_t best = 0;
+		std::size_t bestSize = m_workers[0]->queue.SizeApprox();
+		for (std::size_t i = 1; i < m_workers.size() && bestSize != 0; ++i)
+		{
+			const std::size_t size = m_workers[i]->queue.SizeApprox();
+			if (size < bestSize)
+			{
+				best = i;
+				bestSize = size;
+			}
+		}
+		return best;
+	}
+
+	/// @brief Takes a job from the queue of another worker.
+	bool Steal(std::size_t thief, Job& job)
+	{
+		const std::size_t count = m_workers.size();
+		for (std::size_t i = 1; i < count; ++i)
+		{
+			if (m_workers[(thief + i) % count]->queue.TryPop(job)) return true;
+		}
+		return false;
+	}
+
+	void Run(std::size_t index)
+	{
+		Worker& worker = *m_workers[index];
+		Job job;
+		while (true)
+		{
+			const std::size_t submissions = m_submissions.load(std::memory_order_seq_cst);
+			if (worker.queue.TryPop(job) || Steal(index, job))
+			{
+				worker.handler(job);
+				worker.processed.fetch_add(1, std::memory_order_relaxed);
+				continue;
+			}
+
+			if (m_stopping.load(std::memory_order_acquire))
+			{
+				// Queues were observed empty after the stop request; submissions racing with Stop are not waited for
+				if (!worker.queue.TryPop(job) && !Steal(index, job)) return;
+
+				worker.handler(job);
+				worker.processed.fetch_add(1, std::memory_order_relaxed);
+				continue;
+			}
+
+			Sleep(submissions);
+		}
+	}
+
+	/// @brief Waits until a job is submitted after the queues were found empty, or until Stop.
+	/// @param submissions The submission count read before the queues were found empty.
+	void Sleep(std::size_t submissions)
+	{
+		std::unique_lock<std::mutex> lock(m_sleepMutex);
+		m_sleepers.fetch_add(1, std::memory_order_seq_cst);
+		m_wake.wait(lock, [this, submissions]
+		{
+			return m_submissions.load(std::memory_order_seq_cst) != submissions || m_stopping.load(std::memory_order_acquire);
+		});
+		m_sleepers.fetch_sub(1, std::memory_order_relaxed);
+	}
+
+	void WakeAll()
+	{
+		std::lock_guard<std::mutex> lock(m_sleepMutex);
+		m_wake.notify_all();
+	}
+
+	std::vector<std::unique_ptr<Worker>> m_workers;
+	WorkerSelection m_selection;
+	std::size_t m_capacityPerWorker;
+
+	alignas(CacheLineSize) std::atomic<std::size_t> m_nextWorker{ 0 };
+	std::atomic<bool> m_stopping{ false };
+	std::atomic<std::size_t> m_submissions{ 0 }; ///< Jobs queued so far, tells sleeping workers that there is work.
+	std::atomic<int> m_sleepers{ 0 };
+	std::mutex m_sleepMutex;
+	std::condition_variable m_wake;
+};
@@ -0,0 +1,12 @@
+# Benchmark regression gate, run by ctest: writes fresh benchmark results and compares them with the baseline.
+# Expects BENCH, COMPARE, BASELINE, RESULTS and THRESHOLD to be set with -D.
+
+execute_process(COMMAND ${BENCH} --output ${RESULTS} RESULT_VARIABLE benchResult)
+if(NOT benchResult EQUAL 0)
+    message(FATAL_ERROR "bench_emit failed: ${benchResult}")
+endif()
+
+execute_process(COMMAND ${COMPARE} ${BASELINE} ${RESULTS} --threshold ${THRESHOLD} RESULT_VARIABLE compareResult)
+if(NOT compareResult EQUAL 0)
+    message(FATAL_ERROR "Benchmarks regressed against ${BASELINE}; results are in ${RESULTS}")
+endif()
@@ -0,0 +1,70 @@
+#pragma once
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <utility>
+#include <vector>
+
+// Timing and statistics shared by the benchmark tools (bench_emit, bench_subscribers, bench_startup).
+
+/// @brief Returns the median of a set of samples; 0 for an empty set.
+inline double Median(std::vector<double> values)
+{
+	if (values.empty()) return 0;
+
+	std::sort(values.begin(), values.end());
+	const std::size_t middle = values.size() / 2;
+	return values.size() % 2 == 1 ? values[middle] : (values[middle - 1] + values[middle]) / 2;
+}
+
+/// @brief Returns the median absolute deviation of samples from their median, a spread measure robust to outliers.
+inline double MedianAbsoluteDeviation(const std::vector<double>& samples, double median)
+{
+	std::vector<double> deviations;
+	deviations.reserve(samples.size());
+	for (const double sample : samples)
+	{
+		deviations.push_back(std::fabs(sample - median));
+	}
+	return Median(std::move(deviations));
+}
+
+/// @brief Times a single call.
+/// @return The elapsed wall clock time in nanoseconds.
+template <typename Body>
+double ElapsedNanoseconds(Body&& body)
+{
+	const auto start = std::chrono::steady_clock::now();
+	body();
+	const auto elapsed = std::chrono::steady_clock::now() - start;
+	return std::chrono::duration<double, std::nano>(elapsed).count();
+}
+
+/// @brief Times one call of body per repetition.
+/// @param operations The operations done by one call of body.
+/// @return Nanoseconds per operation, one sample per repetition.
+template <typename Body>
+std::vector<double> SampleNanosecondsPerOperation(std::size_t repetitions, std::size_t operations, Body body)
+{
+	std::vector<double> samples;
+	samples.reserve(repetitions);
+	for (std::size_t repetition = 0; repetition < repetitions; ++repetition)
+	{
+		samples.push_back(ElapsedNanoseconds(body) / static_cast<double>(operations));
+	}
+	return samples;
+}
+
+/// @brief Checks the value the benchmarked subscribers accumulated. Results flow into it so the compiler can not drop
+/// the measured calls; a zero sink means they never ran, and the timings are meaningless.
+/// @return False, after reporting it, if the sink is zero.
+inline bool SinkObserved(std::uint64_t sink)
+{
+	if (sink != 0) return true;
+
+	std::fprintf(stderr, "the benchmarked subscribers were never called\n");
+	return false;
+}
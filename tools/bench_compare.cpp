@@ -0,0 +1,150 @@
+// Compares benchmark results written by bench_emit against a stored baseline and fails on regressions.
+// A benchmark regresses if its median exceeds the baseline median by more than the relative threshold
+// plus a multiple of the noise of both runs (the sum of their median absolute deviations).
+// Usage: bench_compare <baseline.json> <results.json> [--threshold 0.15] [--mad-factor 3]
+// Exit code: 0 if nothing regressed, 1 on a regression or a benchmark missing from the results, 2 on bad input.
+// Build: c++ -std=c++17 bench_compare.cpp -o bench_compare
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace
+{
+	struct Entry
+	{
+		std::string name;
+		double median = 0;
+		double mad = 0;
+	};
+
+	bool ReadFile(const char* path, std::string& out)
+	{
+		std::FILE* file = std::fopen(path, "rb");
+		if (file == nullptr) return false;
+
+		char buffer[4096];
+		std::size_t read;
+		while ((read = std::fread(buffer, 1, sizeof(buffer), file)) > 0)
+		{
+			out.append(buffer, read);
+		}
+		std::fclose(file);
+		return true;
+	}
+
+	/// @brief Reads the number following "key": at or after position.
+	bool ReadNumber(const std::string& text, const char* key, std::size_t position, std::size_t limit, double& out)
+	{
+		const std::size_t found = text.find(key, position);
+		if (found == std::string::npos || found >= limit) return false;
+
+		const std::size_t colon = text.find(':', found);
+		out = std::strtod(text.c_str() + colon + 1, nullptr);
+		return true;
+	}
+
+	/// @brief Extracts name, median and MAD of every benchmark object from the JSON written by bench_emit.
+	bool Parse(const std::string& text, std::vector<Entry>& out)
+	{
+		const char* nameKey = "\"name\"";
+		for (std::size_t position = text.find(nameKey); position != std::string::npos;)
+		{
+			const std::size_t next = text.find(nameKey, position + 1);
+			const std::size_t limit = next == std::string::npos ? text.size() : next;
+
+			const std::size_t open = text.find('"', text.find(':', position) + 1);
+			const std::size_t close = text.find('"', open + 1);
+			if (open == std::string::npos || close == std::string::npos) return false;
+
+			Entry entry;
+			entry.name = text.substr(open + 1, close - open - 1);
+			if (!ReadNumber(text, "\"median\"", close, limit, entry.median) || !ReadNumber(text, "\"mad\"", close, limit, entry.mad)) return false;
+			out.push_back(entry);
+			position = next;
+		}
+		return !out.empty();
+	}
+
+	const Entry* Find(const std::vector<Entry>& entries, const std::string& name)
+	{
+		for (const Entry& entry : entries)
+		{
+			if (entry.name == name) return &entry;
+		}
+		return nullptr;
+	}
+}
+
+int main(int argc, char** argv)
+{
+	if (argc < 3 || argc % 2 == 0)
+	{
+		std::fprintf(stderr, "usage: %s <baseline.json> <results.json> [--threshold 0.15] [--mad-factor 3]\n", argv[0]);
+		return 2;
+	}
+	double threshold = 0.15;
+	double madFactor = 3;
+	for (int i = 3; i + 1 < argc; i += 2)
+	{
+		if (std::strcmp(argv[i], "--threshold") == 0) threshold = std::strtod(argv[i + 1], nullptr);
+		else if (std::strcmp(argv[i], "--mad-factor") == 0) madFactor = std::strtod(argv[i + 1], nullptr);
+		else
+		{
+			std::fprintf(stderr, "unknown option %s\n", argv[i]);
+			return 2;
+		}
+	}
+
+	std::vector<Entry> baseline;
+	std::vector<Entry> results;
+	for (int file = 1; file <= 2; ++file)
+	{
+		std::string text;
+		if (!ReadFile(argv[file], text))
+		{
+			std::perror(argv[file]);
+			return 2;
+		}
+		if (!Parse(text, file == 1 ? baseline : results))
+		{
+			std::fprintf(stderr, "%s: no benchmark results found\n", argv[file]);
+			return 2;
+		}
+	}
+
+	int regressions = 0;
+	std::printf("%-28s %12s %12s %12s %8s\n", "benchmark", "baseline", "current", "allowed", "change");
+	for (const Entry& expected : baseline)
+	{
+		const Entry* current = Find(results, expected.name);
+		if (current == nullptr)
+		{
+			std::printf("%-28s missing from the results\n", expected.name.c_str());
+			++regressions;
+			continue;
+		}
+
+		const double allowed = expected.median * (1 + threshold) + madFactor * (expected.mad + current->mad);
+		const bool regressed = current->median > allowed;
+		std::printf("%-28s %12.2f %12.2f %12.2f %+7.1f%%%s\n", expected.name.c_str(), expected.median, current->median, allowed,
+			(current->median / expected.median - 1) * 100, regressed ? "  REGRESSION" : "");
+		regressions += regressed ? 1 : 0;
+	}
+	for (const Entry& entry : results)
+	{
+		if (Find(baseline, entry.name) == nullptr)
+		{
+			std::printf("%-28s not in the baseline, not checked\n", entry.name.c_str());
+		}
+	}
+
+	if (regressions > 0)
+	{
+		std::printf("%d benchmark(s) regressed\n", regressions);
+		return 1;
+	}
+	return 0;
+}
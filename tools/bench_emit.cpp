@@ -0,0 +1,188 @@
+// Microbenchmarks of the hot paths (Delegate::operator(), SignalBus::Emit) with machine-readable results.
+// Every benchmark is repeated; the JSON output holds the samples plus their median and median absolute
+// deviation (MAD), which bench_compare checks against a stored baseline.
+// Usage: bench_emit [--repetitions N] [--output results.json]
+// Build: c++ -std=c++17 -O2 -I.. bench_emit.cpp -o bench_emit
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <deque>
+#include <string>
+#include <vector>
+
+#include "../SignalBus.hpp"
+#include "BenchmarkCommon.hpp"
+
+namespace
+{
+	struct BenchEvent
+	{
+		std::uint64_t value;
+	};
+
+	struct UnboundEvent
+	{
+		std::uint64_t value;
+	};
+
+	struct Counter
+	{
+		void On(const BenchEvent& event)
+		{
+			sum += event.value;
+		}
+
+		std::uint64_t sum = 0;
+	};
+
+	struct Result
+	{
+		std::string name;
+		std::vector<double> samples; ///< Nanoseconds per operation, one per repetition.
+		double median = 0;
+		double mad = 0;
+	};
+
+	/// @brief Runs a benchmark: one untimed warm-up, then one timed batch per repetition.
+	/// @param operations The operations done by one call of body.
+	template <typename Body>
+	Result Measure(const char* name, std::size_t repetitions, std::size_t operations, Body body)
+	{
+		body();
+
+		Result result;
+		result.name = name;
+		result.samples = SampleNanosecondsPerOperation(repetitions, operations, body);
+		result.median = Median(result.samples);
+		result.mad = MedianAbsoluteDeviation(result.samples, result.median);
+		return result;
+	}
+
+	template <typename Bus>
+	Result MeasureEmit(const char* name, std::size_t repetitions, Bus& bus, Counter& sink)
+	{
+		constexpr std::size_t Emits = 200000;
+		return Measure(name, repetitions, Emits, [&bus, &sink]
+		{
+			for (std::uint64_t i = 0; i < Emits; ++i)
+			{
+				bus.Emit(BenchEvent{ i });
+			}
+			sink.sum += 1;
+		});
+	}
+
+	void WriteJson(std::FILE* file, const std::vector<Result>& results)
+	{
+		std::fprintf(file, "{\n  \"unit\": \"ns/op\",\n  \"benchmarks\": [\n");
+		for (std::size_t i = 0; i < results.size(); ++i)
+		{
+			const Result& result = results[i];
+			std::fprintf(file, "    { \"name\": \"%s\", \"median\": %.3f, \"mad\": %.3f, \"samples\": [", result.name.c_str(), result.median, result.mad);
+			for (std::size_t sample = 0; sample < result.samples.size(); ++sample)
+			{
+				std::fprintf(file, "%s%.3f", sample == 0 ? "" : ", ", result.samples[sample]);
+			}
+			std::fprintf(file, "] }%s\n", i + 1 < results.size() ? "," : "");
+		}
+		std::fprintf(file, "  ]\n}\n");
+	}
+}
+
+int main(int argc, char** argv)
+{
+	std::size_t repetitions = 15;
+	const char* output = nullptr;
+	for (int i = 1; i + 1 < argc; i += 2)
+	{
+		const std::string option = argv[i];
+		if (option == "--repetitions") repetitions = std::strtoul(argv[i + 1], nullptr, 10);
+		else if (option == "--output") output = argv[i + 1];
+		else
+		{
+			std::fprintf(stderr, "usage: %s [--repetitions N] [--output results.json]\n", argv[0]);
+			return 2;
+		}
+	}
+	if (repetitions == 0 || argc % 2 == 0)
+	{
+		std::fprintf(stderr, "usage: %s [--repetitions N] [--output results.json]\n", argv[0]);
+		return 2;
+	}
+
+	std::vector<Result> results;
+	Counter sink;
+
+	{
+		Delegate<void(const BenchEvent&)> delegate;
+		delegate.Bind<Counter, &Counter::On>(&sink);
+		constexpr std::size_t Calls = 1000000;
+		results.push_back(Measure("delegate_call", repetitions, Calls, [&delegate]
+		{
+			for (std::uint64_t i = 0; i < Calls; ++i)
+			{
+				delegate(BenchEvent{ i });
+			}
+		}));
+	}
+	{
+		std::deque<Counter> pool(1);
+		CompactDelegate<void(const BenchEvent&)> delegate;
+		delegate.Bind<Counter, &Counter::On>(pool, 0);
+		constexpr std::size_t Calls = 1000000;
+		results.push_back(Measure("compact_delegate_call", repetitions, Calls, [&delegate]
+		{
+			for (std::uint64_t i = 0; i < Calls; ++i)
+			{
+				delegate(BenchEvent{ i });
+			}
+		}));
+	}
+	{
+		SignalBus bus;
+		bus.Bind<BenchEvent, Counter, &Counter::On>(&sink);
+		constexpr std::size_t Emits = 200000;
+		results.push_back(Measure("emit_unbound_type", repetitions, Emits, [&bus]
+		{
+			for (std::uint64_t i = 0; i < Emits; ++i)
+			{
+				bus.Emit(UnboundEvent{ i });
+			}
+		}));
+	}
+	for (const std::size_t subscribers : { 1, 16, 256 })
+	{
+		SignalBus bus;
+		std::vector<Counter> counters(subscribers);
+		for (Counter& counter : counters)
+		{
+			bus.Bind<BenchEvent, Counter, &Counter::On>(&counter);
+		}
+		const std::string name = "emit_" + std::to_string(subscribers) + "_subscribers";
+		results.push_back(MeasureEmit(name.c_str(), repetitions, bus, sink));
+	}
+
+	for (const Result& result : results)
+	{
+		std::fprintf(stderr, "%-28s median %10.2f ns/op  MAD %8.2f\n", result.name.c_str(), result.median, result.mad);
+	}
+
+	// Checked before writing anything, so a run whose calls were optimized away never becomes a baseline
+	if (!SinkObserved(sink.sum)) return 1;
+
+	if (output == nullptr)
+	{
+		WriteJson(stdout, results);
+		return 0;
+	}
+	std::FILE* file = std::fopen(output, "w");
+	if (file == nullptr)
+	{
+		std::perror(output);
+		return 1;
+	}
+	WriteJson(file, results);
+	std::fclose(file);
+	return 0;
+}
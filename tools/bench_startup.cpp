@@ -0,0 +1,137 @@
+// Time to bind a large number of subscribers to one event type at startup, one at a time with Bind and BindCompact,
+// after Reserve, and in bulk with BindMany (in a single call and in chunks, as when binding level by level).
+// Prints the median time of the repetitions and the time per subscriber.
+// Usage: bench_startup [--subscribers 1000000] [--chunk 1000] [--repetitions 3]
+// Build: c++ -std=c++17 -O2 -I.. bench_startup.cpp -o bench_startup
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include "../SignalBus.hpp"
+#include "BenchmarkCommon.hpp"
+
+namespace
+{
+	struct Tick
+	{
+		std::uint64_t value;
+	};
+
+	struct Counter
+	{
+		void On(const Tick& event)
+		{
+			sum += event.value;
+		}
+
+		std::uint64_t sum = 0;
+	};
+
+	/// @brief Times binding on a fresh bus, repeated; the bus is destroyed outside of the timed region.
+	/// @return Milliseconds, the median of the repetitions.
+	template <typename Body>
+	double Measure(std::size_t repetitions, Counter& check, Body body)
+	{
+		std::vector<double> samples;
+		for (std::size_t repetition = 0; repetition < repetitions; ++repetition)
+		{
+			SignalBus bus;
+			samples.push_back(ElapsedNanoseconds([&body, &bus] { body(bus); }) / 1e6);
+			bus.Emit(Tick{ 1 });
+		}
+		if (!SinkObserved(check.sum)) std::exit(1);
+		check.sum = 0;
+		return Median(samples);
+	}
+}
+
+int main(int argc, char** argv)
+{
+	std::size_t subscribers = 1000000;
+	std::size_t chunk = 1000;
+	std::size_t repetitions = 3;
+	bool valid = argc % 2 == 1;
+	for (int i = 1; valid && i + 1 < argc; i += 2)
+	{
+		const std::string option = argv[i];
+		if (option == "--subscribers") subscribers = std::strtoul(argv[i + 1], nullptr, 10);
+		else if (option == "--chunk") chunk = std::strtoul(argv[i + 1], nullptr, 10);
+		else if (option == "--repetitions") repetitions = std::strtoul(argv[i + 1], nullptr, 10);
+		else valid = false;
+	}
+	if (!valid || subscribers == 0 || subscribers > UINT32_MAX || chunk == 0 || repetitions == 0)
+	{
+		std::fprintf(stderr, "usage: %s [--subscribers 1000000] [--chunk 1000] [--repetitions 3]\n", argv[0]);
+		return 2;
+	}
+
+	std::vector<Counter> counters(subscribers);
+	std::vector<Counter*> instances;
+	instances.reserve(subscribers);
+	for (Counter& counter : counters)
+	{
+		instances.push_back(&counter);
+	}
+	Counter& last = counters.back();
+
+	struct Row
+	{
+		std::string name;
+		double milliseconds;
+	};
+	std::vector<Row> rows;
+
+	rows.push_back({ "Bind", Measure(repetitions, last, [&](SignalBus& bus)
+	{
+		for (Counter* instance : instances)
+		{
+			bus.Bind<Tick, Counter, &Counter::On>(instance);
+		}
+	}) });
+	rows.push_back({ "Reserve + Bind", Measure(repetitions, last, [&](SignalBus& bus)
+	{
+		bus.Reserve<Tick>(subscribers);
+		for (Counter* instance : instances)
+		{
+			bus.Bind<Tick, Counter, &Counter::On>(instance);
+		}
+	}) });
+	rows.push_back({ "BindMany", Measure(repetitions, last, [&](SignalBus& bus)
+	{
+		bus.BindMany<Tick, Counter, &Counter::On>(instances);
+	}) });
+	rows.push_back({ "BindMany in chunks of " + std::to_string(chunk), Measure(repetitions, last, [&](SignalBus& bus)
+	{
+		for (std::size_t first = 0; first < subscribers; first += chunk)
+		{
+			const std::vector<Counter*> part(instances.begin() + first, instances.begin() + std::min(first + chunk, subscribers));
+			bus.BindMany<Tick, Counter, &Counter::On>(part);
+		}
+	}) });
+	rows.push_back({ "BindCompact", Measure(repetitions, last, [&](SignalBus& bus)
+	{
+		for (std::uint32_t i = 0; i < subscribers; ++i)
+		{
+			bus.BindCompact<Tick, Counter, &Counter::On>(counters, i);
+		}
+	}) });
+	rows.push_back({ "Reserve + BindCompact", Measure(repetitions, last, [&](SignalBus& bus)
+	{
+		bus.Reserve<Tick>(subscribers);
+		for (std::uint32_t i = 0; i < subscribers; ++i)
+		{
+			bus.BindCompact<Tick, Counter, &Counter::On>(counters, i);
+		}
+	}) });
+
+	std::printf("%zu subscribers\n%-32s %12s %14s\n", subscribers, "binding", "ms", "ns/subscriber");
+	for (const Row& row : rows)
+	{
+		std::printf("%-32s %12.1f %14.1f\n", row.name.c_str(), row.milliseconds, row.milliseconds * 1e6 / static_cast<double>(subscribers));
+	}
+	return 0;
+}
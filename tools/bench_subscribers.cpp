@@ -0,0 +1,140 @@
+// Emit throughput of one event type at large subscriber counts, per way of storing the subscribers:
+// member function handles (Bind), by-value delegates (BindMany) and 8 byte compact delegates (BindCompact).
+// Prints the median time per emit and per subscriber call, and the subscriber list and handle bytes held per subscriber (including the spare capacity of the lists).
+// Usage: bench_subscribers [--max 1000000] [--repetitions 5]
+// Build: c++ -std=c++17 -O2 -I.. bench_subscribers.cpp -o bench_subscribers
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include "../SignalBus.hpp"
+#include "BenchmarkCommon.hpp"
+
+namespace
+{
+	struct Tick
+	{
+		std::uint64_t value;
+	};
+
+	struct Counter
+	{
+		void On(const Tick& event)
+		{
+			sum += event.value;
+		}
+
+		std::uint64_t sum = 0;
+	};
+
+	enum class Storage
+	{
+		Handles,
+		Delegates,
+		Compact
+	};
+
+	const char* StorageName(Storage storage)
+	{
+		switch (storage)
+		{
+		case Storage::Handles: return "Bind (handles)";
+		case Storage::Delegates: return "BindMany (Delegate)";
+		case Storage::Compact: return "BindCompact";
+		}
+		return "";
+	}
+
+	/// @brief Binds subscribers of one storage kind and times emitting to all of them.
+	/// @return Nanoseconds per emit, the median of the repetitions.
+	double MeasureEmit(Storage storage, std::size_t subscribers, std::size_t repetitions, double& bytesPerSubscriber, std::uint64_t& sink)
+	{
+		SignalBus bus;
+		std::vector<Counter> counters(subscribers);
+		std::vector<Counter*> instances;
+		switch (storage)
+		{
+		case Storage::Handles:
+			for (Counter& counter : counters)
+			{
+				bus.Bind<Tick, Counter, &Counter::On>(&counter);
+			}
+			break;
+		case Storage::Delegates:
+			instances.reserve(subscribers);
+			for (Counter& counter : counters)
+			{
+				instances.push_back(&counter);
+			}
+			bus.BindMany<Tick, Counter, &Counter::On>(instances);
+			break;
+		case Storage::Compact:
+			for (std::uint32_t i = 0; i < subscribers; ++i)
+			{
+				bus.BindCompact<Tick, Counter, &Counter::On>(counters, i);
+			}
+			break;
+		}
+
+		const AllocationTracker& stats = bus.GetAllocationStats();
+		bytesPerSubscriber = static_cast<double>(stats.ForCategory(AllocationCategory::Lists).currentBytes + stats.ForCategory(AllocationCategory::Handles).currentBytes) /
+			static_cast<double>(subscribers);
+
+		// About 20M subscriber calls per repetition, at least 3 emits
+		const std::size_t emits = std::max<std::size_t>(3, 20000000 / subscribers);
+		bus.Emit(Tick{ 1 });
+
+		// One "operation" is a whole emit, to all subscribers
+		const std::vector<double> samples = SampleNanosecondsPerOperation(repetitions, emits, [&bus, emits]
+		{
+			for (std::size_t i = 0; i < emits; ++i)
+			{
+				bus.Emit(Tick{ i });
+			}
+		});
+
+		for (const Counter& counter : counters)
+		{
+			sink += counter.sum;
+		}
+		return Median(samples);
+	}
+}
+
+int main(int argc, char** argv)
+{
+	std::size_t maximum = 1000000;
+	std::size_t repetitions = 5;
+	bool valid = argc % 2 == 1;
+	for (int i = 1; valid && i + 1 < argc; i += 2)
+	{
+		const std::string option = argv[i];
+		if (option == "--max") maximum = std::strtoul(argv[i + 1], nullptr, 10);
+		else if (option == "--repetitions") repetitions = std::strtoul(argv[i + 1], nullptr, 10);
+		else valid = false;
+	}
+	if (!valid || maximum == 0 || maximum > UINT32_MAX || repetitions == 0)
+	{
+		std::fprintf(stderr, "usage: %s [--max 1000000] [--repetitions 5]\n", argv[0]);
+		return 2;
+	}
+
+	std::uint64_t sink = 0;
+	std::printf("%-22s %12s %14s %14s %14s\n", "storage", "subscribers", "ns/emit", "ns/subscriber", "bytes/sub");
+	for (std::size_t subscribers = 1000; subscribers <= maximum; subscribers *= 10)
+	{
+		for (const Storage storage : { Storage::Handles, Storage::Delegates, Storage::Compact })
+		{
+			double bytesPerSubscriber = 0;
+			const double nanoseconds = MeasureEmit(storage, subscribers, repetitions, bytesPerSubscriber, sink);
+			std::printf("%-22s %12zu %14.0f %14.2f %14.1f\n", StorageName(storage), subscribers, nanoseconds,
+				nanoseconds / static_cast<double>(subscribers), bytesPerSubscriber);
+			std::fflush(stdout);
+		}
+	}
+	return SinkObserved(sink) ? 0 : 1;
+}
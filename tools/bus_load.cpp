@@ -0,0 +1,371 @@
+// Load generator and scaling study for SignalBus. Emits a Zipf-distributed mix of event types with mixed payload
+// sizes from several producer threads, each on its own fork of one configured bus, while subscribers are
+// unbound and rebound at a configurable rate. For every thread count it measures the saturated throughput,
+// then the latency at fractions of that throughput.
+//
+// Latency is measured open loop: every producer has a schedule of intended emit times and an emit's latency
+// runs from its intended time, not from when the producer got around to it. A stalled emit therefore also
+// counts against the emits queued up behind it, instead of silently lowering the offered load
+// (coordinated omission).
+//
+// Usage: bus_load [--types N] [--zipf S] [--subscribers N] [--work NS] [--churn PER_SECOND]
+//                 [--threads 1,2,4] [--load 0.25,0.5,0.75,0.9] [--duration MS]
+// Output: two CSV tables, throughput per thread count and latency per thread count and load.
+// Build: c++ -std=c++17 -O2 -I.. bus_load.cpp -o bus_load -pthread
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cinttypes>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "../LatencyHistogram.hpp"
+#include "../SignalBus.hpp"
+
+namespace
+{
+	constexpr std::size_t MaxTypes = 64;
+	constexpr std::array<std::size_t, 4> PayloadSizes = { 8, 32, 128, 512 };
+
+	/// @brief Event type number Index; payload sizes cycle through PayloadSizes.
+	template <std::size_t Index>
+	struct LoadEvent
+	{
+		std::array<unsigned char, PayloadSizes[Index % PayloadSizes.size()]> payload;
+	};
+
+	std::uint64_t workTicks = 0;
+	thread_local std::uint64_t sink = 0;
+
+	/// @brief Reads the payload and busy-waits for the configured work. Holds no state, so the
+	/// subscribers of the configured bus can serve every fork at once.
+	struct LoadSubscriber
+	{
+		template <std::size_t Index>
+		void On(const LoadEvent<Index>& event)
+		{
+			sink += event.payload.front() + event.payload.back();
+			if (workTicks == 0) return;
+
+			const std::uint64_t start = ReadTimestamp();
+			while (ReadTimestamp() - start < workTicks) {}
+		}
+	};
+
+	/// @brief What the producers do with one event type, so types can be picked at runtime.
+	struct TypeOperations
+	{
+		void (*emit)(SignalBus& bus, unsigned char value);
+		void (*bind)(SignalBus& bus, LoadSubscriber* subscriber);
+		void (*unbind)(SignalBus& bus, LoadSubscriber* subscriber);
+	};
+
+	template <std::size_t Index>
+	TypeOperations OperationsOf()
+	{
+		using Event = LoadEvent<Index>;
+		return TypeOperations{
+			[](SignalBus& bus, unsigned char value)
+			{
+				Event event;
+				std::memset(event.payload.data(), value, event.payload.size());
+				bus.Emit(event);
+			},
+			[](SignalBus& bus, LoadSubscriber* subscriber) { bus.Bind<Event, LoadSubscriber, &LoadSubscriber::On<Index>>(subscriber); },
+			[](SignalBus& bus, LoadSubscriber* subscriber) { bus.Unbind<Event, LoadSubscriber, &LoadSubscriber::On<Index>>(subscriber); },
+		};
+	}
+
+	template <std::size_t... Indices>
+	std::array<TypeOperations, sizeof...(Indices)> MakeOperations(std::index_sequence<Indices...>)
+	{
+		return { OperationsOf<Indices>()... };
+	}
+
+	const std::array<TypeOperations, MaxTypes> operations = MakeOperations(std::make_index_sequence<MaxTypes>());
+
+	struct Options
+	{
+		std::size_t types = 32;
+		double zipf = 1.0;
+		std::size_t subscribers = 4;   ///< Per event type.
+		std::uint64_t workNanoseconds = 0;
+		double churnPerSecond = 0;     ///< Unbind and rebind operations per second and producer.
+		std::vector<std::size_t> threads = { 1, 2, 4 };
+		std::vector<double> loads = { 0.25, 0.5, 0.75, 0.9 };
+		std::uint64_t durationMilliseconds = 1000;
+	};
+
+	template <typename T, typename Parse>
+	std::vector<T> ParseList(const char* text, Parse parse)
+	{
+		std::vector<T> values;
+		for (const char* begin = text; *begin != '\0';)
+		{
+			char* end = nullptr;
+			values.push_back(static_cast<T>(parse(begin, &end)));
+			begin = *end == ',' ? end + 1 : end;
+			if (end == begin && *end != '\0') break;
+		}
+		return values;
+	}
+
+	bool ParseOptions(int argc, char** argv, Options& options)
+	{
+		for (int i = 1; i + 1 < argc; i += 2)
+		{
+			const std::string name = argv[i];
+			const char* value = argv[i + 1];
+			if (name == "--types") options.types = std::strtoul(value, nullptr, 10);
+			else if (name == "--zipf") options.zipf = std::strtod(value, nullptr);
+			else if (name == "--subscribers") options.subscribers = std::strtoul(value, nullptr, 10);
+			else if (name == "--work") options.workNanoseconds = std::strtoull(value, nullptr, 10);
+			else if (name == "--churn") options.churnPerSecond = std::strtod(value, nullptr);
+			else if (name == "--threads") options.threads = ParseList<std::size_t>(value, [](const char* text, char** end) { return std::strtoul(text, end, 10); });
+			else if (name == "--load") options.loads = ParseList<double>(value, [](const char* text, char** end) { return std::strtod(text, end); });
+			else if (name == "--duration") options.durationMilliseconds = std::strtoull(value, nullptr, 10);
+			else return false;
+		}
+		return (argc % 2) == 1 && options.types >= 1 && options.types <= MaxTypes && options.subscribers >= 1 &&
+			!options.threads.empty() &&
+			std::none_of(options.threads.begin(), options.threads.end(), [](std::size_t threads) { return threads == 0; }) &&
+			options.durationMilliseconds > 0;
+	}
+
+	/// @brief A precomputed sequence of Zipf-distributed type indices, so sampling stays off the measured path.
+	class TypeSequence
+	{
+	public:
+		TypeSequence(std::size_t types, double exponent, std::uint64_t seed)
+		{
+			std::vector<double> cumulative(types);
+			double sum = 0;
+			for (std::size_t rank = 0; rank < types; ++rank)
+			{
+				sum += 1.0 / std::pow(static_cast<double>(rank + 1), exponent);
+				cumulative[rank] = sum;
+			}
+
+			std::mt19937_64 random(seed);
+			std::uniform_real_distribution<double> uniform(0, sum);
+			for (auto& type : m_types)
+			{
+				type = static_cast<std::uint8_t>(std::lower_bound(cumulative.begin(), cumulative.end(), uniform(random)) - cumulative.begin());
+			}
+		}
+
+		std::size_t operator[](std::uint64_t i) const
+		{
+			return m_types[i & (m_types.size() - 1)];
+		}
+
+	private:
+		std::array<std::uint8_t, 1 << 16> m_types{};
+	};
+
+	/// @brief What one producer measured in one run.
+	struct ProducerResult
+	{
+		std::uint64_t emits = 0;
+		std::uint64_t churns = 0;
+		std::uint64_t firstTicks = 0; ///< When the first emit started.
+		std::uint64_t lastTicks = 0;  ///< When the last emit completed.
+		LatencyHistogram latency;
+	};
+
+	/// @brief Runs all producers for one measurement.
+	/// @param perThreadRate Emits per second and producer; 0 runs closed loop, as fast as possible, without latency.
+	std::vector<ProducerResult> Run(const SignalBus& configured, std::vector<std::vector<LoadSubscriber>>& subscribers,
+		const Options& options, std::size_t threadCount, double perThreadRate)
+	{
+		const double ticksPerNanosecond = TimestampTicksPerNanosecond();
+		const auto durationTicks = static_cast<std::uint64_t>(static_cast<double>(options.durationMilliseconds) * 1e6 * ticksPerNanosecond);
+		const double intervalTicks = perThreadRate > 0 ? 1e9 * ticksPerNanosecond / perThreadRate : 0;
+		const double churnTicks = options.churnPerSecond > 0 ? 1e9 * ticksPerNanosecond / options.churnPerSecond : 0;
+
+		// Forking has to happen before the producers start; afterwards every fork is used by one thread only
+		std::vector<SignalBus> buses;
+		buses.reserve(threadCount);
+		for (std::size_t i = 0; i < threadCount; ++i)
+		{
+			buses.push_back(configured.Fork());
+		}
+
+		std::vector<ProducerResult> results(threadCount);
+		std::vector<std::thread> producers;
+		const std::uint64_t start = ReadTimestamp() + static_cast<std::uint64_t>(10e6 * ticksPerNanosecond);
+		for (std::size_t thread = 0; thread < threadCount; ++thread)
+		{
+			producers.emplace_back([&, thread]
+			{
+				SignalBus& bus = buses[thread];
+				ProducerResult& result = results[thread];
+				const TypeSequence sequence(options.types, options.zipf, 0x5eed + thread);
+				std::mt19937_64 random(thread);
+				const std::uint64_t end = start + durationTicks;
+				double nextChurn = static_cast<double>(start) + churnTicks;
+
+				while (ReadTimestamp() < start) {}
+
+				for (std::uint64_t i = 0;; ++i)
+				{
+					std::uint64_t intended = 0;
+					if (perThreadRate > 0)
+					{
+						// Wait for the intended time of this emit, but never skip one that is already late
+						intended = start + static_cast<std::uint64_t>(static_cast<double>(i) * intervalTicks);
+						if (intended >= end) break;
+						while (ReadTimestamp() < intended) {}
+					}
+
+					if (i == 0)
+					{
+						result.firstTicks = ReadTimestamp();
+					}
+					operations[sequence[i]].emit(bus, static_cast<unsigned char>(i));
+					const std::uint64_t now = ReadTimestamp();
+					result.lastTicks = now;
+					if (perThreadRate > 0)
+					{
+						result.latency.Record(now - intended);
+					}
+					++result.emits;
+
+					if (churnTicks > 0 && static_cast<double>(now) >= nextChurn)
+					{
+						// Replace one subscriber of a popular type; each fork copies the list on its first change
+						const std::size_t type = sequence[random()];
+						LoadSubscriber* subscriber = &subscribers[type][random() % subscribers[type].size()];
+						operations[type].unbind(bus, subscriber);
+						operations[type].bind(bus, subscriber);
+						++result.churns;
+						nextChurn += churnTicks;
+					}
+					if (perThreadRate == 0 && now >= end) break;
+				}
+			});
+		}
+		for (auto& producer : producers)
+		{
+			producer.join();
+		}
+		return results;
+	}
+
+	/// @brief Returns the emits per second of all producers, over the measured time from the first emit to the completion
+	/// of the last one. An open loop run that can not keep up takes longer than configured and shows a lower rate.
+	double EmitsPerSecond(const std::vector<ProducerResult>& results)
+	{
+		std::uint64_t emits = 0;
+		std::uint64_t first = ~std::uint64_t{ 0 };
+		std::uint64_t last = 0;
+		for (const auto& result : results)
+		{
+			if (result.emits == 0) continue;
+
+			emits += result.emits;
+			first = std::min(first, result.firstTicks);
+			last = std::max(last, result.lastTicks);
+		}
+		if (emits == 0 || last <= first) return 0;
+
+		return static_cast<double>(emits) * 1e9 * TimestampTicksPerNanosecond() / static_cast<double>(last - first);
+	}
+
+	/// @brief Returns an upper bound of a percentile over the histograms of all producers.
+	double PercentileNanoseconds(const std::vector<ProducerResult>& results, double percentile)
+	{
+		std::uint64_t count = 0;
+		std::uint64_t maxTicks = 0;
+		for (const auto& result : results)
+		{
+			count += result.latency.Count();
+			maxTicks = std::max<std::uint64_t>(maxTicks, static_cast<std::uint64_t>(result.latency.Max().count() * TimestampTicksPerNanosecond()));
+		}
+		if (count == 0) return 0;
+
+		const auto rank = static_cast<std::uint64_t>(percentile / 100.0 * static_cast<double>(count - 1)) + 1;
+		std::uint64_t seen = 0;
+		for (std::size_t bucket = 0; bucket < LatencyHistogram::BucketCount; ++bucket)
+		{
+			for (const auto& result : results)
+			{
+				seen += result.latency.BucketValue(bucket);
+			}
+			if (seen >= rank)
+			{
+				return static_cast<double>(std::min(LatencyHistogram::UpperBoundOf(bucket), maxTicks)) / TimestampTicksPerNanosecond();
+			}
+		}
+		return static_cast<double>(maxTicks) / TimestampTicksPerNanosecond();
+	}
+}
+
+int main(int argc, char** argv)
+{
+	Options options;
+	if (!ParseOptions(argc, argv, options))
+	{
+		std::fprintf(stderr,
+			"usage: %s [--types 1..%zu] [--zipf S] [--subscribers 1..] [--work NS] [--churn PER_SECOND]\n"
+			"          [--threads 1,2,4] [--load 0.25,0.5,0.75,0.9] [--duration MS]\n", argv[0], MaxTypes);
+		return 2;
+	}
+	workTicks = static_cast<std::uint64_t>(static_cast<double>(options.workNanoseconds) * TimestampTicksPerNanosecond());
+
+	// The configured bus every producer forks: every type with the same number of subscribers
+	SignalBus configured;
+	std::vector<std::vector<LoadSubscriber>> subscribers(options.types, std::vector<LoadSubscriber>(options.subscribers));
+	for (std::size_t type = 0; type < options.types; ++type)
+	{
+		for (auto& subscriber : subscribers[type])
+		{
+			operations[type].bind(configured, &subscriber);
+		}
+	}
+
+	std::printf("# types=%zu zipf=%.2f subscribers=%zu work=%" PRIu64 "ns churn=%.0f/s duration=%" PRIu64 "ms\n",
+		options.types, options.zipf, options.subscribers, options.workNanoseconds, options.churnPerSecond, options.durationMilliseconds);
+
+	std::vector<double> saturated(options.threads.size());
+	std::printf("\n# throughput\nthreads,emits_per_second,emits_per_second_per_thread,churns\n");
+	for (std::size_t i = 0; i < options.threads.size(); ++i)
+	{
+		const std::size_t threads = options.threads[i];
+		const auto results = Run(configured, subscribers, options, threads, 0);
+		std::uint64_t churns = 0;
+		for (const auto& result : results)
+		{
+			churns += result.churns;
+		}
+		saturated[i] = EmitsPerSecond(results);
+		std::printf("%zu,%.0f,%.0f,%" PRIu64 "\n", threads, saturated[i], saturated[i] / static_cast<double>(threads), churns);
+		std::fflush(stdout);
+	}
+
+	std::printf("\n# latency (from intended emit time)\nthreads,load,target_per_second,achieved_per_second,p50_ns,p90_ns,p99_ns,p99.9_ns,max_ns\n");
+	for (std::size_t i = 0; i < options.threads.size(); ++i)
+	{
+		const std::size_t threads = options.threads[i];
+		for (const double load : options.loads)
+		{
+			const double target = saturated[i] * load;
+			const auto results = Run(configured, subscribers, options, threads, target / static_cast<double>(threads));
+			const double achieved = EmitsPerSecond(results);
+			std::printf("%zu,%.2f,%.0f,%.0f,%.0f,%.0f,%.0f,%.0f,%.0f\n", threads, load, target, achieved,
+				PercentileNanoseconds(results, 50), PercentileNanoseconds(results, 90), PercentileNanoseconds(results, 99),
+				PercentileNanoseconds(results, 99.9), PercentileNanoseconds(results, 100));
+			std::fflush(stdout);
+		}
+	}
+	return 0;
+}
@@ -0,0 +1,160 @@
+// Shows the live emit rates and handler times of a process publishing LiveStatistics, refreshed like top.
+// Usage: bustop <pid | segment name> [refresh interval in ms] [rows]
+// Build: c++ -std=c++17 -I.. bustop.cpp -o bustop (add -lrt on older glibc)
+
+#include <algorithm>
+#include <chrono>
+#include <cerrno>
+#include <cinttypes>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "../LiveStatistics.hpp"
+
+namespace
+{
+	volatile std::sig_atomic_t stopRequested = 0;
+
+	struct Row
+	{
+		std::string name;
+		double emitsPerSecond = 0;
+		double meanNanoseconds = 0; ///< Mean handler time per emit during the last interval.
+		double maxNanoseconds = 0;  ///< Slowest emit since the process attached the segment.
+		std::uint64_t emits = 0;
+	};
+
+	std::string FormatDuration(double nanoseconds)
+	{
+		char text[32];
+		if (nanoseconds < 1e3) std::snprintf(text, sizeof(text), "%.0f ns", nanoseconds);
+		else if (nanoseconds < 1e6) std::snprintf(text, sizeof(text), "%.1f us", nanoseconds / 1e3);
+		else if (nanoseconds < 1e9) std::snprintf(text, sizeof(text), "%.1f ms", nanoseconds / 1e6);
+		else std::snprintf(text, sizeof(text), "%.2f s", nanoseconds / 1e9);
+		return text;
+	}
+}
+
+int main(int argc, char** argv)
+{
+	if (argc < 2)
+	{
+		std::fprintf(stderr, "usage: %s <pid | segment name> [refresh interval in ms] [rows]\n", argv[0]);
+		return 2;
+	}
+
+	std::string name = argv[1];
+	if (name.find_first_not_of("0123456789") == std::string::npos)
+	{
+		name = "/signalbus." + name;
+	}
+	const auto interval = std::chrono::milliseconds(argc > 2 ? std::strtol(argv[2], nullptr, 10) : 1000);
+	const std::size_t rows = argc > 3 ? std::strtoul(argv[3], nullptr, 10) : 20;
+
+	const int file = ::shm_open(name.c_str(), O_RDONLY, 0);
+	if (file < 0)
+	{
+		std::perror(name.c_str());
+		return 1;
+	}
+	struct stat status {};
+	if (::fstat(file, &status) != 0 || static_cast<std::size_t>(status.st_size) < sizeof(LiveStatisticsHeader))
+	{
+		std::fprintf(stderr, "%s: too small for a live statistics segment\n", name.c_str());
+		return 1;
+	}
+	const auto size = static_cast<std::size_t>(status.st_size);
+	void* mapping = ::mmap(nullptr, size, PROT_READ, MAP_SHARED, file, 0);
+	::close(file);
+	if (mapping == MAP_FAILED)
+	{
+		std::perror(name.c_str());
+		return 1;
+	}
+
+	const auto* header = static_cast<const LiveStatisticsHeader*>(mapping);
+	if (std::memcmp(header->magic, LiveStatisticsHeader::Magic, sizeof(header->magic)) != 0 ||
+		header->version != LiveStatisticsHeader::CurrentVersion ||
+		size < sizeof(LiveStatisticsHeader) + header->typeCapacity * sizeof(LiveTypeRecord))
+	{
+		std::fprintf(stderr, "%s: not a live statistics segment of a supported version\n", name.c_str());
+		return 1;
+	}
+	const auto* records = reinterpret_cast<const LiveTypeRecord*>(static_cast<const unsigned char*>(mapping) + sizeof(LiveStatisticsHeader));
+
+	std::signal(SIGINT, [](int) { stopRequested = 1; });
+
+	// The previous sample of every record, to turn the counters into rates
+	std::vector<LiveTypeCounters> previous(header->typeCapacity);
+	auto previousTime = std::chrono::steady_clock::now();
+	for (std::uint32_t i = 0; i < std::min(header->typeCount.load(), header->typeCapacity); ++i)
+	{
+		ReadLiveTypeRecord(records[i], previous[i]);
+	}
+
+	while (stopRequested == 0)
+	{
+		std::this_thread::sleep_for(interval);
+		const auto now = std::chrono::steady_clock::now();
+		const double seconds = std::chrono::duration<double>(now - previousTime).count();
+		previousTime = now;
+
+		std::vector<Row> table;
+		double totalRate = 0;
+		const std::uint32_t count = std::min(header->typeCount.load(std::memory_order_acquire), header->typeCapacity);
+		for (std::uint32_t i = 0; i < count; ++i)
+		{
+			LiveTypeCounters current;
+			if (!ReadLiveTypeRecord(records[i], current)) continue; // Keep the previous sample, the next interval covers both
+
+			Row row;
+			row.name = records[i].name;
+			const std::uint64_t emits = current.emits - previous[i].emits;
+			row.emits = current.emits;
+			row.emitsPerSecond = static_cast<double>(emits) / seconds;
+			row.meanNanoseconds = emits == 0 ? 0 :
+				static_cast<double>(current.handlerTicks - previous[i].handlerTicks) / static_cast<double>(emits) / header->ticksPerNanosecond;
+			row.maxNanoseconds = static_cast<double>(current.maxHandlerTicks) / header->ticksPerNanosecond;
+			totalRate += row.emitsPerSecond;
+			table.push_back(row);
+			previous[i] = current;
+		}
+		std::sort(table.begin(), table.end(), [](const Row& left, const Row& right)
+		{
+			return left.emitsPerSecond * left.meanNanoseconds > right.emitsPerSecond * right.meanNanoseconds ||
+				(left.emitsPerSecond * left.meanNanoseconds == right.emitsPerSecond * right.meanNanoseconds && left.emitsPerSecond > right.emitsPerSecond);
+		});
+
+		// Clear the screen, then one line per event type, the types keeping the handlers busiest first
+		std::printf("\033[H\033[2J");
+		std::printf("bustop - pid %" PRId64 ", %s, %u event types, %.0f emits/s\n\n", header->processId, name.c_str(), count, totalRate);
+		std::printf("%-48s %12s %10s %10s %8s %14s\n", "event type", "emits/s", "mean", "max", "busy", "emits");
+		for (std::size_t row = 0; row < std::min(rows, table.size()); ++row)
+		{
+			const Row& entry = table[row];
+			const double busy = entry.emitsPerSecond * entry.meanNanoseconds / 1e7; // Percent of one thread
+			std::printf("%-48.48s %12.0f %10s %10s %7.1f%% %14" PRIu64 "\n", entry.name.c_str(), entry.emitsPerSecond,
+				FormatDuration(entry.meanNanoseconds).c_str(), FormatDuration(entry.maxNanoseconds).c_str(), busy, entry.emits);
+		}
+		std::fflush(stdout);
+
+		if (::kill(static_cast<pid_t>(header->processId), 0) != 0 && errno == ESRCH)
+		{
+			std::printf("\nprocess %" PRId64 " has exited\n", header->processId);
+			break;
+		}
+	}
+
+	::munmap(mapping, size);
+	return 0;
+}
@@ -0,0 +1,247 @@
+// Checks the allocation accounting of SignalBus: emitting never allocates, and binding, unbinding and forking
+// are reported in the right internal structure (AllocationCategory) and under the right event type.
+// Usage: check_allocations (exit code 0 if every check passed)
+// Build: c++ -std=c++17 -I.. check_allocations.cpp -o check_allocations
+
+#include <cstddef>
+#include <cstdio>
+#include <deque>
+#include <vector>
+
+#include "../SignalBus.hpp"
+
+namespace
+{
+	int failures = 0;
+
+	void Check(bool condition, const char* what)
+	{
+		if (!condition)
+		{
+			std::printf("FAILED: %s\n", what);
+			++failures;
+		}
+	}
+
+	struct Tick
+	{
+		int value;
+	};
+
+	struct Message
+	{
+		int value;
+	};
+
+	struct Unbound
+	{
+		int value;
+	};
+
+	struct Receiver
+	{
+		void OnTick(const Tick& event) { sum += event.value; }
+		void OnMessage(const Message& event) { sum += event.value; }
+		void Peek(const Tick& event) const { peeked += event.value; }
+
+		int sum = 0;
+		mutable int peeked = 0;
+	};
+
+	int freeSum = 0;
+
+	void OnTickFree(const Tick& event)
+	{
+		freeSum += event.value;
+	}
+
+	std::size_t Allocations(const SignalBus& bus, AllocationCategory category)
+	{
+		return bus.GetAllocationStats().ForCategory(category).allocations;
+	}
+
+	std::size_t CurrentBytes(const SignalBus& bus, AllocationCategory category)
+	{
+		return bus.GetAllocationStats().ForCategory(category).currentBytes;
+	}
+
+	template <typename Event>
+	std::size_t TypeBytes(const SignalBus& bus)
+	{
+		const AllocationCounters* counters = bus.GetAllocationStats().ForType<Event>();
+		return counters != nullptr ? counters->currentBytes.load() : 0;
+	}
+
+	template <typename Event>
+	std::size_t TypeAllocations(const SignalBus& bus)
+	{
+		const AllocationCounters* counters = bus.GetAllocationStats().ForType<Event>();
+		return counters != nullptr ? counters->allocations.load() : 0;
+	}
+
+	/// @brief Binds one subscriber of every kind to Tick, emits in a loop and checks that nothing was allocated.
+	void CheckEmitDoesNotAllocate()
+	{
+		SignalBus bus;
+		Receiver receiver;
+		Receiver grouped;
+		std::deque<Receiver> pool(4);
+		SubscriptionNode<Tick> node;
+		SubscriptionGroup group = bus.GetGroup("group");
+
+		bus.Bind<Tick, Receiver, &Receiver::OnTick>(&receiver);
+		bus.Bind<Tick, Receiver, &Receiver::Peek>(&receiver);
+		bus.Bind<Tick, &OnTickFree>();
+		bus.Bind<Tick, Receiver, &Receiver::OnTick>(&grouped, group);
+		bus.Bind<Tick, Receiver, &Receiver::OnTick>(&receiver, node);
+		for (std::uint32_t i = 0; i < pool.size(); ++i)
+		{
+			bus.BindCompact<Tick, Receiver, &Receiver::OnTick>(pool, i);
+		}
+		bus.Bind<Message, Receiver, &Receiver::OnMessage>(&receiver);
+
+		const AllocationTracker& stats = bus.GetAllocationStats();
+		const std::size_t before = stats.Total().allocations;
+		const std::size_t bytesBefore = stats.Total().currentBytes;
+		for (int i = 0; i < 10000; ++i)
+		{
+			bus.Emit(Tick{ 1 });
+			bus.Emit(Message{ 1 });
+			bus.Emit(Unbound{ 1 });
+			if (i == 5000) group.Mute();
+		}
+		group.Resume();
+
+		std::printf("emit: %zu allocations before and %zu after 30000 emits\n", before, stats.Total().allocations.load());
+		Check(stats.Total().allocations == before, "emitting does not allocate");
+		Check(stats.Total().currentBytes == bytesBefore, "emitting does not change the held bytes");
+		Check(stats.ForType<Unbound>() == nullptr, "emitting an event type nobody is bound to creates no counters");
+		Check(receiver.sum == 30000 && receiver.peeked == 10000 && freeSum == 10000 && grouped.sum == 5001 && pool[3].sum == 10000,
+			"every subscriber was called");
+	}
+
+	/// @brief Checks which internal structure and which event type binding and unbinding are accounted to.
+	void CheckBindAndUnbind()
+	{
+		SignalBus bus;
+		Receiver first;
+		Receiver second;
+		std::deque<Receiver> pool(1);
+
+		Check(bus.GetAllocationStats().Total().currentBytes == 0, "an empty bus holds no accounted memory");
+
+		// The first member function of a type allocates the map node, the subscriber list and one handle
+		bus.Bind<Tick, Receiver, &Receiver::OnTick>(&first);
+		Check(Allocations(bus, AllocationCategory::Map) > 0, "binding a new event type allocates in the map");
+		Check(Allocations(bus, AllocationCategory::Lists) > 0, "binding a new event type allocates a subscriber list");
+		Check(Allocations(bus, AllocationCategory::Handles) == 1, "binding a member function allocates one handle");
+		Check(Allocations(bus, AllocationCategory::Queues) == 0, "binding does not touch the queue");
+		Check(TypeBytes<Tick>(bus) > 0, "the subscriber list and handle are accounted to the event type");
+		Check(bus.GetAllocationStats().ForType<Message>() == nullptr, "other event types have no counters");
+		Check(TypeBytes<Tick>(bus) == CurrentBytes(bus, AllocationCategory::Lists) + CurrentBytes(bus, AllocationCategory::Handles),
+			"the event type holds exactly the list and handle bytes");
+
+		// Binding another event type leaves the counters of the first one alone
+		const std::size_t tickBytes = TypeBytes<Tick>(bus);
+		const std::size_t tickAllocations = TypeAllocations<Tick>(bus);
+		bus.Bind<Message, Receiver, &Receiver::OnMessage>(&first);
+		Check(TypeBytes<Tick>(bus) == tickBytes && TypeAllocations<Tick>(bus) == tickAllocations, "binding another event type leaves Tick alone");
+		Check(TypeBytes<Message>(bus) > 0, "the new event type has its own counters");
+		Check(Allocations(bus, AllocationCategory::Handles) == 2, "every member function binding allocates one handle");
+
+		// Free functions and compact subscribers are stored inside the list, without a handle
+		bus.Bind<Tick, &OnTickFree>();
+		bus.BindCompact<Tick, Receiver, &Receiver::OnTick>(pool, 0);
+		Check(Allocations(bus, AllocationCategory::Handles) == 2, "free functions and compact subscribers allocate no handle");
+
+		// Unbinding releases the handle, accounted to the same category and event type
+		bus.Bind<Tick, Receiver, &Receiver::OnTick>(&second);
+		const std::size_t handleBytes = CurrentBytes(bus, AllocationCategory::Handles);
+		const std::size_t tickBytesBound = TypeBytes<Tick>(bus);
+		bus.Unbind<Tick, Receiver, &Receiver::OnTick>(&second);
+		const std::size_t released = handleBytes - CurrentBytes(bus, AllocationCategory::Handles);
+		Check(bus.GetAllocationStats().ForCategory(AllocationCategory::Handles).deallocations == 1, "unbinding releases the handle");
+		Check(released > 0 && TypeBytes<Tick>(bus) == tickBytesBound - released, "the released handle is subtracted from the event type");
+		Check(TypeBytes<Message>(bus) > 0, "unbinding Tick leaves Message alone");
+
+		bus.Unbind<Tick, Receiver, &Receiver::OnTick>(&first);
+		bus.Unbind<Message, Receiver, &Receiver::OnMessage>(&first);
+		Check(CurrentBytes(bus, AllocationCategory::Handles) == 0, "no handle is held after unbinding every member function");
+		Check(bus.GetAllocationStats().ForCategory(AllocationCategory::Handles).peakBytes >= handleBytes, "the peak keeps the high water mark");
+
+		const std::size_t total = bus.GetAllocationStats().Total().currentBytes;
+		std::size_t categories = 0;
+		for (std::size_t category = 0; category < static_cast<std::size_t>(AllocationCategory::Count); ++category)
+		{
+			categories += CurrentBytes(bus, static_cast<AllocationCategory>(category));
+		}
+		std::printf("bind/unbind: %zu bytes held, %zu bytes per handle\n", total, released);
+		Check(total == categories, "the total is the sum of the categories");
+	}
+
+	/// @brief Checks that a fork shares the subscriber lists until it changes them, then accounts its copy on its own.
+	void CheckFork()
+	{
+		SignalBus bus;
+		Receiver receiver;
+		Receiver added;
+		Receiver grouped;
+		bus.Bind<Tick, Receiver, &Receiver::OnTick>(&receiver);
+		bus.Bind<Message, Receiver, &Receiver::OnMessage>(&receiver);
+
+		const AllocationTracker& stats = bus.GetAllocationStats();
+		const std::size_t allocations = stats.Total().allocations;
+		const std::size_t tickBytes = TypeBytes<Tick>(bus);
+
+		SignalBus fork = bus.Fork();
+		Check(stats.Total().allocations == allocations, "forking does not allocate on the forked bus");
+		Check(Allocations(fork, AllocationCategory::Map) > 0, "the fork allocates its own map");
+		Check(Allocations(fork, AllocationCategory::Lists) == 0, "the fork shares the subscriber lists");
+		Check(Allocations(fork, AllocationCategory::Handles) == 0, "the fork shares the handles");
+		Check(TypeBytes<Tick>(fork) == 0, "shared lists stay accounted to the bus that allocated them");
+
+		// Binding on the fork copies the Tick list into the fork, leaving Message shared
+		fork.Bind<Tick, Receiver, &Receiver::OnTick>(&added);
+		Check(Allocations(fork, AllocationCategory::Lists) > 0, "binding on the fork copies the list into the fork");
+		Check(Allocations(fork, AllocationCategory::Handles) == 2, "the fork copies the existing handle and allocates the new one");
+		Check(TypeBytes<Tick>(fork) > 0, "the copied list is accounted to the event type on the fork");
+		Check(TypeBytes<Message>(fork) == 0, "the untouched Message list is still shared");
+		Check(stats.Total().allocations == allocations && TypeBytes<Tick>(bus) == tickBytes, "binding on the fork leaves the forked bus alone");
+
+		// Emitting on either bus does not allocate, whether the list is shared or copied
+		const std::size_t forkAllocations = fork.GetAllocationStats().Total().allocations;
+		for (int i = 0; i < 1000; ++i)
+		{
+			bus.Emit(Tick{ 1 });
+			fork.Emit(Tick{ 1 });
+			fork.Emit(Message{ 1 });
+		}
+		Check(stats.Total().allocations == allocations && fork.GetAllocationStats().Total().allocations == forkAllocations,
+			"emitting on a fork or the forked bus does not allocate");
+		Check(receiver.sum == 3000 && added.sum == 1000, "both buses call their own subscribers");
+
+		// Unbinding on the forked bus copies nothing into the fork
+		bus.Unbind<Message, Receiver, &Receiver::OnMessage>(&receiver);
+		Check(fork.GetAllocationStats().Total().allocations == forkAllocations, "unbinding on the forked bus does not allocate on the fork");
+
+		// Lists with group subscribers are copied right away, together with the group
+		SubscriptionGroup group = bus.GetGroup("group");
+		bus.Bind<Message, Receiver, &Receiver::OnMessage>(&grouped, group);
+		SignalBus groupedFork = bus.Fork();
+		Check(Allocations(groupedFork, AllocationCategory::Lists) > 0, "the fork copies the group and the lists with group subscribers");
+		Check(TypeBytes<Message>(groupedFork) > 0, "the copied list is accounted to its event type on the fork");
+		Check(TypeBytes<Tick>(groupedFork) == 0, "lists without group subscribers stay shared");
+		std::printf("fork: %zu allocations on the fork after binding, %zu on a fork with a group\n", forkAllocations,
+			groupedFork.GetAllocationStats().Total().allocations.load());
+	}
+}
+
+int main()
+{
+	CheckEmitDoesNotAllocate();
+	CheckBindAndUnbind();
+	CheckFork();
+
+	std::printf(failures == 0 ? "all checks passed\n" : "%d checks failed\n", failures);
+	return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,123 @@
+// Checks what a forked bus inherits: the Emit subscribers are shared, the single receiver of sent events is not,
+// and binding, unbinding or muting on either side after the fork leaves the other bus alone.
+// Usage: check_fork (exit code 0 if every check passed)
+// Build: c++ -std=c++17 -I.. check_fork.cpp -o check_fork
+
+#include <cstdio>
+#include <memory>
+#include <utility>
+
+#include "../Mailbox.hpp"
+#include "../SignalBus.hpp"
+
+namespace
+{
+	int failures = 0;
+
+	void Check(bool condition, const char* what)
+	{
+		if (!condition)
+		{
+			std::printf("FAILED: %s\n", what);
+			++failures;
+		}
+	}
+
+	/// @brief Move-only payload, so a sent event can only ever have one owner.
+	struct Frame
+	{
+		std::unique_ptr<int> pixels;
+	};
+
+	struct Tick
+	{
+		int value;
+	};
+
+	struct Counter
+	{
+		void On(const Tick&) { ++ticks; }
+		void OnFrame(const Frame&) { ++frames; }
+
+		int ticks = 0;
+		int frames = 0;
+	};
+
+	void CheckReceiver()
+	{
+		SignalBus bus;
+		Mailbox<Frame> inbox;
+		bus.BindReceiver<Frame, Mailbox<Frame>, &Mailbox<Frame>::Receive>(&inbox);
+
+		SignalBus fork = bus.Fork();
+		Check(!fork.Send(Frame{ std::make_unique<int>(1) }), "the fork has no receiver");
+		Check(inbox.Empty(), "sending on the fork does not reach the original's receiver");
+		Check(bus.Send(Frame{ std::make_unique<int>(2) }) && inbox.Size() == 1, "the original keeps its receiver");
+
+		bus.Bind<Frame>([](const Frame&) {});
+		Check(bus.Send(Frame{ std::make_unique<int>(3) }) && inbox.Size() == 2, "binding on the original after the fork keeps its receiver");
+
+		Mailbox<Frame> forkInbox;
+		fork.BindReceiver<Frame, Mailbox<Frame>, &Mailbox<Frame>::Receive>(&forkInbox);
+		Check(fork.Send(Frame{ std::make_unique<int>(4) }) && forkInbox.Size() == 1 && inbox.Size() == 2, "the fork binds its own receiver");
+		Check(bus.Send(Frame{ std::make_unique<int>(5) }) && inbox.Size() == 3 && forkInbox.Size() == 1, "each bus sends to its own receiver");
+
+		fork.UnbindReceiver<Frame>();
+		Check(!fork.Send(Frame{ std::make_unique<int>(6) }) && bus.Send(Frame{ std::make_unique<int>(7) }) && inbox.Size() == 4,
+			"unbinding the fork's receiver leaves the original's");
+	}
+
+	void CheckSharedSubscribers()
+	{
+		SignalBus bus;
+		Counter original;
+		bus.Bind<Tick, Counter, &Counter::On>(&original);
+		Mailbox<Frame> inbox;
+		bus.BindReceiver<Frame, Mailbox<Frame>, &Mailbox<Frame>::Receive>(&inbox);
+
+		SignalBus fork = bus.Fork();
+		fork.Emit(Tick{ 1 });
+		Check(original.ticks == 1, "the fork emits to the inherited subscribers");
+
+		Counter added;
+		fork.Bind<Tick, Counter, &Counter::On>(&added);
+		bus.Emit(Tick{ 1 });
+		Check(original.ticks == 2 && added.ticks == 0, "a subscriber bound on the fork is not bound on the original");
+
+		bus.Unbind<Tick, Counter, &Counter::On>(&original);
+		fork.Emit(Tick{ 1 });
+		Check(original.ticks == 3 && added.ticks == 1, "unbinding on the original leaves the fork's subscribers");
+	}
+
+	/// @brief A channel with both group subscribers and a receiver is copied into the fork, without the receiver.
+	void CheckGroups()
+	{
+		SignalBus bus;
+		Counter counter;
+		bus.Bind<Frame, Counter, &Counter::OnFrame>(&counter, bus.GetGroup("ui"));
+		Mailbox<Frame> inbox;
+		bus.BindReceiver<Frame, Mailbox<Frame>, &Mailbox<Frame>::Receive>(&inbox);
+
+		SignalBus fork = bus.Fork();
+		fork.GetGroup("ui").Mute();
+		bus.Emit(Frame{});
+		fork.Emit(Frame{});
+		Check(counter.frames == 1, "muting the fork's copy of a group leaves the original's group alone");
+		Check(!fork.Send(Frame{ std::make_unique<int>(1) }) && bus.Send(Frame{ std::make_unique<int>(2) }) && inbox.Size() == 1,
+			"only the original has the receiver");
+
+		fork.GetGroup("ui").Resume();
+		fork.Emit(Frame{});
+		Check(counter.frames == 2, "the fork keeps the group subscribers of the copied channel");
+	}
+}
+
+int main()
+{
+	CheckReceiver();
+	CheckSharedSubscribers();
+	CheckGroups();
+
+	std::printf(failures == 0 ? "all checks passed\n" : "%d checks failed\n", failures);
+	return failures == 0 ? 0 : 1;
+}
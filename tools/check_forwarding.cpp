@@ -0,0 +1,236 @@
+// Checks forwarding between parent and child buses: up and down forwarding, filters, rejected cycles, and that
+// destroying or moving a bus inside a hierarchy leaves no link into freed memory (build with -fsanitize=address
+// to turn such a link into a report instead of a wrong count).
+// Usage: check_forwarding (exit code 0 if every check passed)
+// Build: c++ -std=c++17 -I.. check_forwarding.cpp -o check_forwarding
+
+#include <cstdio>
+#include <memory>
+#include <utility>
+
+#include "../SignalBus.hpp"
+
+namespace
+{
+	int failures = 0;
+
+	void Check(bool condition, const char* what)
+	{
+		if (!condition)
+		{
+			std::printf("FAILED: %s\n", what);
+			++failures;
+		}
+	}
+
+	struct Input
+	{
+		int value;
+	};
+
+	struct Config
+	{
+		int value;
+	};
+
+	struct Counter
+	{
+		void OnInput(const Input&) { ++inputs; }
+		void OnConfig(const Config&) { ++configs; }
+
+		int inputs = 0;
+		int configs = 0;
+	};
+
+	/// @brief A bus with a counter bound to both event types.
+	struct Node
+	{
+		Node()
+		{
+			bus.Bind<Input, Counter, &Counter::OnInput>(&counter);
+			bus.Bind<Config, Counter, &Counter::OnConfig>(&counter);
+		}
+
+		Counter counter;
+		SignalBus bus;
+	};
+
+	template <typename Body>
+	bool Throws(Body body)
+	{
+		try
+		{
+			body();
+		}
+		catch (const ForwardingCycle&)
+		{
+			return true;
+		}
+		return false;
+	}
+
+	void CheckUpAndDown()
+	{
+		Node global;
+		Node world;
+		Node window;
+		world.bus.SetParent(&global.bus);
+		window.bus.SetParent(&world.bus);
+		Check(window.bus.GetParent() == &world.bus && world.bus.GetParent() == &global.bus, "the parents are set");
+
+		window.bus.ForwardToParent<Input>();
+		world.bus.ForwardToParent<Input>();
+		window.bus.Emit(Input{ 1 });
+		Check(window.counter.inputs == 1 && world.counter.inputs == 1 && global.counter.inputs == 1, "forwarding to the parent is transitive");
+		world.bus.Emit(Input{ 1 });
+		Check(window.counter.inputs == 1 && world.counter.inputs == 2 && global.counter.inputs == 2, "forwarding up never reaches the children");
+
+		global.bus.ForwardToChildren<Config>();
+		global.bus.Emit(Config{ 1 });
+		Check(global.counter.configs == 1 && world.counter.configs == 1 && window.counter.configs == 0, "children get the event, grandchildren only by their parent's rule");
+
+		// A child added later picks up the existing rule
+		Node late;
+		late.bus.SetParent(&global.bus);
+		global.bus.Emit(Config{ 1 });
+		Check(world.counter.configs == 2 && late.counter.configs == 1, "a rule applies to children added later");
+
+		global.bus.StopForwardingToChildren<Config>();
+		window.bus.StopForwardingToParent<Input>();
+		global.bus.Emit(Config{ 1 });
+		window.bus.Emit(Input{ 1 });
+		Check(world.counter.configs == 2 && late.counter.configs == 1 && world.counter.inputs == 2, "stopped rules no longer forward");
+	}
+
+	void CheckFilter()
+	{
+		Node parent;
+		Node child;
+		child.bus.SetParent(&parent.bus);
+		child.bus.ForwardToParent<Input>([](const Input& event) { return event.value > 0; });
+
+		child.bus.Emit(Input{ -1 });
+		Check(child.counter.inputs == 1 && parent.counter.inputs == 0, "a rejected event still reaches the own subscribers, but is not forwarded");
+		child.bus.Emit(Input{ 1 });
+		Check(child.counter.inputs == 2 && parent.counter.inputs == 1, "an accepted event is forwarded");
+	}
+
+	void CheckCycles()
+	{
+		Node parent;
+		Node child;
+		child.bus.SetParent(&parent.bus);
+		child.bus.ForwardToParent<Input>();
+
+		Check(Throws([&parent] { parent.bus.ForwardToChildren<Input>(); }), "forwarding A to B to A is rejected");
+		parent.bus.Emit(Input{ 1 });
+		Check(parent.counter.inputs == 1 && child.counter.inputs == 0, "the rejected rule was not applied");
+		child.bus.Emit(Input{ 1 });
+		Check(parent.counter.inputs == 2 && child.counter.inputs == 1, "the existing rule still forwards once");
+
+		Check(Throws([&parent, &child] { parent.bus.SetParent(&child.bus); }), "a bus can not become a child of its own child");
+
+		// Setting a parent whose rules close a cycle with the child's rules fails and leaves the child detached
+		Node other;
+		other.bus.ForwardToChildren<Input>();
+		Check(Throws([&child, &other] { child.bus.SetParent(&other.bus); }), "a parent closing a cycle is rejected");
+		Check(child.bus.GetParent() == nullptr, "the rejected parent is not kept");
+		other.bus.Emit(Input{ 1 });
+		child.bus.Emit(Input{ 1 });
+		Check(other.counter.inputs == 1 && child.counter.inputs == 2 && parent.counter.inputs == 2, "no link of the rejected parent is left");
+	}
+
+	void CheckDestruction()
+	{
+		// The parent goes first: the child's link to the parent has to be removed
+		Node child;
+		{
+			auto parent = std::make_unique<Node>();
+			child.bus.SetParent(&parent->bus);
+			child.bus.ForwardToParent<Input>();
+			parent->bus.ForwardToChildren<Config>();
+			child.bus.Emit(Input{ 1 });
+			Check(parent->counter.inputs == 1, "the child forwards to its parent");
+		}
+		Check(child.bus.GetParent() == nullptr, "destroying the parent detaches the child");
+		child.bus.Emit(Input{ 1 });
+		child.bus.Emit(Config{ 1 });
+		Check(child.counter.inputs == 2 && child.counter.configs == 1, "the child keeps working after its parent is gone");
+
+		// The child goes first: the parent's link down has to be removed
+		Node parent;
+		parent.bus.ForwardToChildren<Config>();
+		{
+			Node shortLived;
+			shortLived.bus.SetParent(&parent.bus);
+			shortLived.bus.ForwardToParent<Input>();
+			parent.bus.Emit(Config{ 1 });
+			Check(shortLived.counter.configs == 1, "the parent forwards to its child");
+		}
+		parent.bus.Emit(Config{ 1 });
+		Check(parent.counter.configs == 2, "the parent keeps working after its child is gone");
+
+		// A new child with the same rules links again
+		Node next;
+		next.bus.SetParent(&parent.bus);
+		parent.bus.Emit(Config{ 1 });
+		Check(next.counter.configs == 1, "a later child is linked again");
+	}
+
+	void CheckMove()
+	{
+		auto parent = std::make_unique<Node>();
+		Node child;
+		child.bus.SetParent(&parent->bus);
+		child.bus.ForwardToParent<Input>();
+		parent->bus.ForwardToChildren<Config>();
+
+		// Move construction: the relatives now refer to the new bus
+		SignalBus moved(std::move(child.bus));
+		Check(moved.GetParent() == &parent->bus, "a moved child keeps its parent");
+		Check(child.bus.GetParent() == nullptr, "the moved-from bus is not in the hierarchy");
+		moved.Emit(Input{ 1 });
+		parent->bus.Emit(Config{ 1 });
+		Check(parent->counter.inputs == 1 && child.counter.configs == 1, "forwarding follows the moved bus both ways");
+
+		// Move assignment into a bus that is itself in another hierarchy
+		Node otherParent;
+		SignalBus assigned;
+		assigned.SetParent(&otherParent.bus);
+		assigned.ForwardToParent<Input>();
+		assigned = std::move(moved);
+		Check(assigned.GetParent() == &parent->bus && moved.GetParent() == &otherParent.bus, "move assignment swaps the positions");
+		assigned.Emit(Input{ 1 });
+		moved.Emit(Input{ 1 });
+		Check(parent->counter.inputs == 2 && otherParent.counter.inputs == 1, "both swapped buses forward to their own parent");
+		{
+			SignalBus expiring(std::move(moved));
+		}
+		otherParent.bus.Emit(Config{ 1 });
+		Check(otherParent.counter.configs == 1, "destroying a moved bus detaches it");
+
+		// Moving the parent: the child follows the new parent object, then the parent is destroyed first
+		auto newParent = std::make_unique<SignalBus>(std::move(parent->bus));
+		Check(assigned.GetParent() == newParent.get(), "a child follows its moved parent");
+		newParent->Emit(Config{ 1 });
+		Check(child.counter.configs == 2, "the moved parent still forwards down");
+		parent.reset();
+		newParent.reset();
+		Check(assigned.GetParent() == nullptr, "destroying the moved parent detaches the child");
+		assigned.Emit(Input{ 1 });
+		assigned.Emit(Config{ 1 });
+		Check(child.counter.inputs == 3 && child.counter.configs == 3, "the child keeps working after the moved parent is gone");
+	}
+}
+
+int main()
+{
+	CheckUpAndDown();
+	CheckFilter();
+	CheckCycles();
+	CheckDestruction();
+	CheckMove();
+
+	std::printf(failures == 0 ? "all checks passed\n" : "%d checks failed\n", failures);
+	return failures == 0 ? 0 : 1;
+}
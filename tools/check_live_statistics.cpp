@@ -0,0 +1,178 @@
+// Checks the records LiveStatistics publishes: buses alternating between segments count into their own segment,
+// type names sharing a long prefix get records of their own, and types beyond the capacity are left out.
+// Reads the segments back through shared memory, like bustop.
+// Usage: check_live_statistics (exit code 0 if every check passed)
+// Build: c++ -std=c++17 -I.. check_live_statistics.cpp -o check_live_statistics (add -lrt on older glibc)
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include "../SignalBus.hpp"
+
+namespace
+{
+	int failures = 0;
+
+	void Check(bool condition, const char* what)
+	{
+		if (!condition)
+		{
+			std::printf("FAILED: %s\n", what);
+			++failures;
+		}
+	}
+
+	struct Tick
+	{
+		int value;
+	};
+
+	struct Frame
+	{
+		int value;
+	};
+
+	struct Input
+	{
+		int value;
+	};
+
+	namespace a_namespace_with_a_name_long_enough_that_the_names_of_its_types_do_not_fit_into_a_live_statistics_record
+	{
+		template <int N>
+		struct Event
+		{
+			int value;
+		};
+	}
+
+	/// @brief Read-only view of a segment, mapped the way bustop maps it.
+	class SegmentView
+	{
+	public:
+		explicit SegmentView(const LiveStatistics& statistics)
+		{
+			const int file = ::shm_open(statistics.Name().c_str(), O_RDONLY, 0);
+			if (file < 0) return;
+
+			LiveStatisticsHeader header;
+			if (::pread(file, &header, sizeof(header), 0) == static_cast<ssize_t>(sizeof(header)))
+			{
+				m_size = sizeof(LiveStatisticsHeader) + header.typeCapacity * sizeof(LiveTypeRecord);
+				void* mapping = ::mmap(nullptr, m_size, PROT_READ, MAP_SHARED, file, 0);
+				m_mapping = mapping != MAP_FAILED ? static_cast<const unsigned char*>(mapping) : nullptr;
+			}
+			::close(file);
+		}
+
+		SegmentView(const SegmentView&) = delete;
+		auto operator=(const SegmentView&)->SegmentView & = delete;
+
+		~SegmentView()
+		{
+			if (m_mapping != nullptr) ::munmap(const_cast<unsigned char*>(m_mapping), m_size);
+		}
+
+		std::uint32_t TypeCount() const
+		{
+			return m_mapping != nullptr ? reinterpret_cast<const LiveStatisticsHeader*>(m_mapping)->typeCount.load() : 0;
+		}
+
+		/// @brief Returns the emits counted by the records whose display name contains a text, summed.
+		std::uint64_t Emits(const char* text) const
+		{
+			if (m_mapping == nullptr) return 0;
+
+			const auto* records = reinterpret_cast<const LiveTypeRecord*>(m_mapping + sizeof(LiveStatisticsHeader));
+			std::uint64_t emits = 0;
+			for (std::uint32_t i = 0; i < TypeCount(); ++i)
+			{
+				LiveTypeCounters counters;
+				if (std::strstr(records[i].name, text) != nullptr && ReadLiveTypeRecord(records[i], counters)) emits += counters.emits;
+			}
+			return emits;
+		}
+
+	private:
+		const unsigned char* m_mapping = nullptr;
+		std::size_t m_size = 0;
+	};
+
+	std::string SegmentName(const char* suffix)
+	{
+		return LiveStatistics::DefaultName() + ".check." + suffix;
+	}
+
+	void CheckAlternatingSegments()
+	{
+		LiveStatistics first(SegmentName("first"));
+		LiveStatistics second(SegmentName("second"));
+		SignalBus one;
+		SignalBus other;
+		one.SetLiveStatistics(&first);
+		other.SetLiveStatistics(&second);
+
+		for (int i = 0; i < 100; ++i)
+		{
+			one.Emit(Tick{ i });
+			other.Emit(Tick{ i });
+			other.Emit(Tick{ i });
+			one.Emit(Frame{ i });
+		}
+
+		const SegmentView firstView(first);
+		const SegmentView secondView(second);
+		Check(firstView.TypeCount() == 2 && secondView.TypeCount() == 1, "each segment has records only for the types emitted on its buses");
+		Check(firstView.Emits("Tick") == 100 && firstView.Emits("Frame") == 100, "the first segment counts its own emits");
+		Check(secondView.Emits("Tick") == 200, "the second segment counts its own emits");
+	}
+
+	void CheckLongNames()
+	{
+		namespace long_names = a_namespace_with_a_name_long_enough_that_the_names_of_its_types_do_not_fit_into_a_live_statistics_record;
+
+		LiveStatistics statistics(SegmentName("names"));
+		SignalBus bus;
+		bus.SetLiveStatistics(&statistics);
+		bus.Emit(long_names::Event<1>{ 1 });
+		bus.Emit(long_names::Event<2>{ 2 });
+		bus.Emit(long_names::Event<2>{ 2 });
+
+		const SegmentView view(statistics);
+		Check(view.TypeCount() == 2, "types whose names only differ after the displayed part get a record each");
+		Check(view.Emits("a_namespace_with") == 3, "the truncated records count every emit");
+	}
+
+	void CheckCapacity()
+	{
+		LiveStatistics statistics(SegmentName("capacity"), 2);
+		SignalBus bus;
+		bus.SetLiveStatistics(&statistics);
+		for (int i = 0; i < 3; ++i)
+		{
+			bus.Emit(Tick{ i });
+			bus.Emit(Frame{ i });
+			bus.Emit(Input{ i });
+		}
+
+		const SegmentView view(statistics);
+		Check(view.TypeCount() == 2, "types beyond the capacity get no record");
+		Check(view.Emits("Tick") == 3 && view.Emits("Frame") == 3 && view.Emits("Input") == 0, "the published types are still counted");
+	}
+}
+
+int main()
+{
+	CheckAlternatingSegments();
+	CheckLongNames();
+	CheckCapacity();
+
+	std::printf(failures == 0 ? "all checks passed\n" : "%d checks failed\n", failures);
+	return failures == 0 ? 0 : 1;
+}
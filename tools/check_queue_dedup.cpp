@@ -0,0 +1,204 @@
+// Checks duplicate suppression of queued events (DeduplicateWhileQueued): lookups in the open addressing set of
+// pending events after erasing from the middle of a collision cluster, also one wrapping around the end of the table,
+// cancelled duplicates, and a randomized run against a simple model of the queue.
+// Usage: check_queue_dedup (exit code 0 if every check passed)
+// Build: c++ -std=c++17 -I.. check_queue_dedup.cpp -o check_queue_dedup
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "../SignalBus.hpp"
+
+namespace
+{
+	int failures = 0;
+
+	void Check(bool condition, const char* what)
+	{
+		if (!condition)
+		{
+			std::printf("FAILED: %s\n", what);
+			++failures;
+		}
+	}
+
+	/// @brief Deduplicated event with a chosen hash, so tests decide which events collide.
+	struct Keyed
+	{
+		static constexpr bool DeduplicateWhileQueued = true;
+
+		int id;
+		std::size_t hash;
+
+		std::size_t Hash() const { return hash; }
+		bool operator==(const Keyed& other) const { return id == other.id; }
+	};
+
+	struct Recorder
+	{
+		void On(const Keyed& event)
+		{
+			order.push_back(event.id);
+		}
+
+		std::string Order() const
+		{
+			std::string text;
+			for (const int id : order)
+			{
+				text += (text.empty() ? "" : " ") + std::to_string(id);
+			}
+			return text;
+		}
+
+		std::vector<int> order;
+	};
+
+	/// @brief Enqueues a copy of an event and reports whether it was dropped as a duplicate.
+	bool Deduplicated(SignalBus& bus, const Keyed& event, const EnqueueOptions& options = {})
+	{
+		const std::uint64_t before = bus.GetQueueStats().deduplicated;
+		bus.Enqueue(event, options);
+		return bus.GetQueueStats().deduplicated != before;
+	}
+
+	/// @brief Queues a, b, c colliding on one home position, d homed on the next one and e homed right behind them,
+	/// so they form a single cluster, dispatches b from the middle of it and looks up the entries behind the hole.
+	/// Erasing b shifts c and d back, while e has to stay at its home position.
+	void CheckCluster(std::size_t home, const char* name)
+	{
+		SignalBus bus;
+		Recorder recorder;
+		bus.Bind<Keyed, Recorder, &Recorder::On>(&recorder);
+
+		EnqueueOptions high;
+		high.priority = QueuePriority::High;
+		const Keyed a{ 1, home };
+		const Keyed b{ 2, home };
+		const Keyed c{ 3, home };
+		const Keyed d{ 4, home + 1 };
+		const Keyed e{ 5, home + 4 };
+		bus.Enqueue(a);
+		bus.Enqueue(b, high); // Dispatched first, although in the middle of the cluster
+		bus.Enqueue(c);
+		bus.Enqueue(d);
+		bus.Enqueue(e);
+
+		bus.DispatchFor(DispatchBudget::Events(1));
+		const bool found = Deduplicated(bus, a) && Deduplicated(bus, c) && Deduplicated(bus, d) && Deduplicated(bus, e);
+		const bool erased = !Deduplicated(bus, b);
+		std::printf("%s: dispatched \"%s\", %zu pending\n", name, recorder.Order().c_str(), bus.GetQueueStats().pending);
+		Check(recorder.Order() == "2", "the event in the middle of the cluster is dispatched first");
+		Check(found, "every entry behind the erased one is still found");
+		Check(erased, "the dispatched event no longer counts as pending");
+
+		bus.DispatchFor();
+		Check(recorder.Order() == "2 1 3 4 5 2", "every event is dispatched once");
+	}
+
+	void CheckCancelledDuplicate()
+	{
+		SignalBus bus;
+		Recorder recorder;
+		bus.Bind<Keyed, Recorder, &Recorder::On>(&recorder);
+
+		const Keyed event{ 7, 42 };
+		QueuedEvent cancelled = bus.Enqueue(event);
+		cancelled.Cancel();
+		Check(!Deduplicated(bus, event), "a cancelled event does not suppress a fresh enqueue of the same value");
+		Check(Deduplicated(bus, event), "the fresh event suppresses further duplicates");
+
+		bus.DispatchFor();
+		const QueueStats stats = bus.GetQueueStats();
+		Check(recorder.Order() == "7" && stats.cancelled == 1 && stats.deduplicated == 1, "the fresh event is dispatched once, the cancelled one skipped");
+		Check(!Deduplicated(bus, event), "after the dispatch the value can be queued again");
+	}
+
+	/// @brief Random enqueues, cancels and single event dispatches of a few heavily colliding values, compared with a model.
+	void CheckRandomized()
+	{
+		struct Queued
+		{
+			int id;
+			QueuedEvent handle;
+			bool cancelled;
+		};
+
+		SignalBus bus;
+		Recorder recorder;
+		bus.Bind<Keyed, Recorder, &Recorder::On>(&recorder);
+
+		std::vector<Queued> model; // In dispatch order, all events share one lane
+		std::vector<int> expected;
+		std::uint64_t expectedDeduplicated = 0;
+		std::uint32_t random = 12345;
+		const auto next = [&random](std::uint32_t range)
+		{
+			random = random * 1664525u + 1013904223u;
+			return (random >> 8) % range;
+		};
+
+		bool consistent = true;
+		for (int step = 0; step < 20000 && consistent; ++step)
+		{
+			const std::uint32_t action = next(10);
+			if (action < 6)
+			{
+				// 24 distinct values on 3 hashes: long clusters, and the table grows several times
+				const int id = static_cast<int>(next(24));
+				const Keyed event{ id, static_cast<std::size_t>(id % 3) * 16 };
+				bool duplicate = false;
+				for (const Queued& queued : model)
+				{
+					duplicate = duplicate || (queued.id == id && !queued.cancelled);
+				}
+				const QueuedEvent handle = bus.Enqueue(event);
+				if (duplicate) ++expectedDeduplicated;
+				else model.push_back(Queued{ id, handle, false });
+				consistent = handle.IsPending() && bus.GetQueueStats().deduplicated == expectedDeduplicated;
+			}
+			else if (action < 8)
+			{
+				if (model.empty()) continue;
+				Queued& victim = model[next(static_cast<std::uint32_t>(model.size()))];
+				consistent = victim.handle.Cancel() != victim.cancelled;
+				victim.cancelled = true;
+			}
+			else
+			{
+				// Dispatch skips cancelled events without counting them against the budget
+				while (!model.empty() && model.front().cancelled)
+				{
+					model.erase(model.begin());
+				}
+				if (!model.empty())
+				{
+					expected.push_back(model.front().id);
+					model.erase(model.begin());
+				}
+				bus.DispatchFor(DispatchBudget::Events(1));
+				consistent = recorder.order == expected;
+			}
+		}
+		bus.DispatchFor();
+		for (const Queued& queued : model)
+		{
+			if (!queued.cancelled) expected.push_back(queued.id);
+		}
+		std::printf("randomized: %zu dispatched, %llu deduplicated\n", recorder.order.size(), static_cast<unsigned long long>(expectedDeduplicated));
+		Check(consistent && recorder.order == expected, "the queue matches the model after every step");
+	}
+}
+
+int main()
+{
+	CheckCluster(3, "cluster");
+	CheckCluster(15, "cluster wrapping around the table end"); // The set starts with 16 entries
+	CheckCancelledDuplicate();
+	CheckRandomized();
+
+	std::printf(failures == 0 ? "all checks passed\n" : "%d checks failed\n", failures);
+	return failures == 0 ? 0 : 1;
+}
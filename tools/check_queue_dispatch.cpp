@@ -0,0 +1,196 @@
+// Checks that SignalBus::DispatchFor only dispatches events queued before the call: events enqueued by handlers
+// wait for the next call even with a higher priority or an earlier deadline, and never displace older events.
+// Also checks QueuedEvent cancellation: before dispatch, from inside the event's own handler and with a stale handle.
+// Usage: check_queue_dispatch (exit code 0 if every check passed)
+// Build: c++ -std=c++17 -I.. check_queue_dispatch.cpp -o check_queue_dispatch
+
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "../SignalBus.hpp"
+
+namespace
+{
+	int failures = 0;
+
+	void Check(bool condition, const char* what)
+	{
+		if (!condition)
+		{
+			std::printf("FAILED: %s\n", what);
+			++failures;
+		}
+	}
+
+	struct E
+	{
+		int value;
+	};
+
+	/// @brief Records the dispatch order; the first event it sees enqueues another one with the configured options.
+	struct Recorder
+	{
+		void On(const E& event)
+		{
+			order.push_back(event.value);
+			if (event.value == 1)
+			{
+				bus->Enqueue(E{ 99 }, options);
+			}
+		}
+
+		std::string Order() const
+		{
+			std::string text;
+			for (const int value : order)
+			{
+				text += (text.empty() ? "" : " ") + std::to_string(value);
+			}
+			return text;
+		}
+
+		SignalBus* bus = nullptr;
+		EnqueueOptions options;
+		std::vector<int> order;
+	};
+
+	/// @brief Tries to cancel the event it is handling, through the handle Enqueue returned for it.
+	struct SelfCanceller
+	{
+		void On(const E& event)
+		{
+			++calls;
+			value = event.value;
+			pendingInHandler = handle.IsPending();
+			cancelledInHandler = handle.Cancel();
+		}
+
+		QueuedEvent handle;
+		int calls = 0;
+		int value = 0;
+		bool pendingInHandler = true;
+		bool cancelledInHandler = true;
+	};
+
+	/// @brief Queues E{1} and E{2}, lets the handler of E{1} enqueue E{99} with the given options and dispatches twice.
+	void CheckEnqueuedByHandler(const EnqueueOptions& queued, const EnqueueOptions& enqueuedByHandler, const char* name)
+	{
+		SignalBus bus;
+		Recorder recorder;
+		recorder.bus = &bus;
+		recorder.options = enqueuedByHandler;
+		bus.Bind<E, Recorder, &Recorder::On>(&recorder);
+
+		bus.Enqueue(E{ 1 }, queued);
+		bus.Enqueue(E{ 2 }, queued);
+
+		const std::size_t first = bus.DispatchFor();
+		std::printf("%s: first call \"%s\"", name, recorder.Order().c_str());
+		Check(first == 2 && recorder.Order() == "1 2", "the first call dispatches exactly the events queued before it");
+		Check(bus.GetQueueStats().pending == 1, "the event enqueued by the handler stays queued");
+
+		const std::size_t second = bus.DispatchFor();
+		std::printf(", second call \"%s\"\n", recorder.Order().c_str());
+		Check(second == 1 && recorder.Order() == "1 2 99", "the next call dispatches the event enqueued by the handler");
+	}
+
+	void CheckCancel()
+	{
+		// Cancelled before dispatch: skipped, and the handle stays dead
+		{
+			SignalBus bus;
+			Recorder recorder;
+			recorder.bus = &bus;
+			bus.Bind<E, Recorder, &Recorder::On>(&recorder);
+			QueuedEvent handle = bus.Enqueue(E{ 5 });
+			bus.Enqueue(E{ 6 });
+			Check(handle.IsPending(), "a queued event is pending");
+			Check(handle.Cancel(), "a pending event can be cancelled");
+			Check(!handle.IsPending() && !handle.Cancel(), "a cancelled event is no longer pending and can not be cancelled twice");
+			const std::size_t dispatched = bus.DispatchFor();
+			Check(dispatched == 1 && recorder.Order() == "6", "dispatch skips the cancelled event");
+			Check(bus.GetQueueStats().cancelled == 1, "the skipped event is counted as cancelled");
+		}
+
+		// Cancelled from inside its own handler: the event is in flight, so neither pending nor cancellable
+		{
+			SignalBus bus;
+			SelfCanceller canceller;
+			bus.Bind<E, SelfCanceller, &SelfCanceller::On>(&canceller);
+			canceller.handle = bus.Enqueue(E{ 7 });
+			bus.DispatchFor();
+			std::printf("cancel inside the own handler: pending %d, cancelled %d\n", canceller.pendingInHandler, canceller.cancelledInHandler);
+			Check(canceller.calls == 1 && canceller.value == 7, "the event was dispatched once");
+			Check(!canceller.pendingInHandler, "an event is not pending while its handler runs");
+			Check(!canceller.cancelledInHandler, "Cancel from inside the own handler reports the event as dispatched");
+			Check(bus.GetQueueStats().cancelled == 0 && bus.GetQueueStats().dispatched == 1, "the event counts as dispatched, not cancelled");
+		}
+
+		// Stale handles: the slot of a dispatched or cancelled event is reused by the next one
+		{
+			SignalBus bus;
+			Recorder recorder;
+			recorder.bus = &bus;
+			bus.Bind<E, Recorder, &Recorder::On>(&recorder);
+
+			QueuedEvent dispatched = bus.Enqueue(E{ 2 });
+			bus.DispatchFor();
+			QueuedEvent reused = bus.Enqueue(E{ 3 });
+			Check(!dispatched.IsPending() && !dispatched.Cancel(), "the handle of a dispatched event stays dead when its slot is reused");
+			Check(reused.IsPending(), "the stale handle did not cancel the event now in its slot");
+
+			QueuedEvent cancelled = bus.Enqueue(E{ 4 });
+			cancelled.Cancel();
+			bus.DispatchFor();
+			QueuedEvent next = bus.Enqueue(E{ 8 });
+			Check(!cancelled.IsPending() && !cancelled.Cancel(), "the handle of a cancelled event stays dead when its slot is reused");
+			bus.DispatchFor();
+			Check(recorder.Order() == "2 3 8", "events in reused slots are dispatched");
+			Check(!next.IsPending(), "a dispatched event is no longer pending");
+		}
+	}
+}
+
+int main()
+{
+	const auto later = std::chrono::steady_clock::now() + std::chrono::hours(1);
+	const auto sooner = std::chrono::steady_clock::now() + std::chrono::minutes(30);
+
+	EnqueueOptions normal;
+	EnqueueOptions high;
+	high.priority = QueuePriority::High;
+	EnqueueOptions lateDeadline;
+	lateDeadline.deadline = later;
+	EnqueueOptions earlyDeadline;
+	earlyDeadline.deadline = sooner;
+	EnqueueOptions highEarlyDeadline = earlyDeadline;
+	highEarlyDeadline.priority = QueuePriority::High;
+
+	CheckEnqueuedByHandler(normal, high, "higher priority");
+	CheckEnqueuedByHandler(lateDeadline, earlyDeadline, "earlier deadline");
+	CheckEnqueuedByHandler(normal, highEarlyDeadline, "higher priority with deadline");
+	CheckEnqueuedByHandler(normal, normal, "same priority");
+
+	// A budget of one event still leaves the older event ahead of the one enqueued by the handler
+	{
+		SignalBus bus;
+		Recorder recorder;
+		recorder.bus = &bus;
+		recorder.options = earlyDeadline;
+		bus.Bind<E, Recorder, &Recorder::On>(&recorder);
+		bus.Enqueue(E{ 1 }, lateDeadline);
+		bus.Enqueue(E{ 2 }, lateDeadline);
+		bus.DispatchFor(DispatchBudget::Events(1));
+		bus.DispatchFor(DispatchBudget::Events(1));
+		bus.DispatchFor(DispatchBudget::Events(1));
+		std::printf("budget of one event: \"%s\"\n", recorder.Order().c_str());
+		Check(recorder.Order() == "1 99 2", "an event enqueued during an earlier call competes normally in later calls");
+	}
+
+	CheckCancel();
+
+	std::printf(failures == 0 ? "all checks passed\n" : "%d checks failed\n", failures);
+	return failures == 0 ? 0 : 1;
+}
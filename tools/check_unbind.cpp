@@ -0,0 +1,200 @@
+// Checks unbinding: Unbind after Bind leaves nothing to call for member, const member, free function and lambda
+// subscriptions, and the bulk UnbindRange and UnbindIf remove the matching member function handles, by-value,
+// compact, group and intrusive node subscriptions of every event type, return how many they removed, and leave the rest.
+// Usage: check_unbind (exit code 0 if every check passed)
+// Build: c++ -std=c++17 -I.. check_unbind.cpp -o check_unbind
+
+#include <cstdio>
+#include <vector>
+
+#include "../SignalBus.hpp"
+
+namespace
+{
+	int failures = 0;
+
+	void Check(bool condition, const char* what)
+	{
+		if (!condition)
+		{
+			std::printf("FAILED: %s\n", what);
+			++failures;
+		}
+	}
+
+	struct Tick
+	{
+		int value;
+	};
+
+	struct Frame
+	{
+		int value;
+	};
+
+	struct Subscriber
+	{
+		void On(const Tick&) { ++calls; }
+		void OnConst(const Tick&) const { ++calls; }
+		void OnFrame(const Frame&) { ++calls; }
+
+		mutable int calls = 0;
+		SubscriptionNode<Tick> node;
+	};
+
+	int freeCalls = 0;
+	int lambdaCalls = 0;
+
+	void OnTickFree(const Tick&)
+	{
+		++freeCalls;
+	}
+
+	/// @brief Binds the subscribers of a pool with one subscription kind each: [0] a member function handle and an
+	/// intrusive node, [1] a const member function, [2] BindMany, [3] compact, [4] a group; [0] also for Frame.
+	/// @return The number of subscriptions bound.
+	int BindEveryKind(SignalBus& bus, std::vector<Subscriber>& pool)
+	{
+		bus.Bind<Tick, Subscriber, &Subscriber::On>(&pool[0]);
+		bus.Bind<Tick, Subscriber, &Subscriber::On>(&pool[0], pool[0].node);
+		bus.Bind<Tick, Subscriber, &Subscriber::OnConst>(&pool[1]);
+		Subscriber* many[] = { &pool[2] };
+		bus.BindMany<Tick, Subscriber, &Subscriber::On>(many);
+		bus.BindCompact<Tick, Subscriber, &Subscriber::On>(pool, 3);
+		bus.Bind<Tick, Subscriber, &Subscriber::On>(&pool[4], bus.GetGroup("level"));
+		bus.Bind<Frame, Subscriber, &Subscriber::OnFrame>(&pool[0]);
+		return 7;
+	}
+
+	int Calls(const std::vector<Subscriber>& pool)
+	{
+		int calls = 0;
+		for (const Subscriber& subscriber : pool)
+		{
+			calls += subscriber.calls;
+		}
+		return calls;
+	}
+
+	void Emit(SignalBus& bus)
+	{
+		bus.Emit(Tick{ 1 });
+		bus.Emit(Frame{ 1 });
+	}
+
+	/// @brief Bind, Unbind, Emit for every kind of single subscription, twice, so the emptied list is also rebuilt.
+	/// The subscriber is the only one of its event type, so Unbind also drops the type from the bus.
+	void CheckBindUnbind()
+	{
+		const auto lambda = [](const Tick&) { ++lambdaCalls; };
+		for (int round = 0; round < 2; ++round)
+		{
+			SignalBus bus;
+			Subscriber subscriber;
+			freeCalls = lambdaCalls = 0;
+
+			bus.Bind<Tick, Subscriber, &Subscriber::On>(&subscriber);
+			bus.Unbind<Tick, Subscriber, &Subscriber::On>(&subscriber);
+			bus.Emit(Tick{ 1 });
+			Check(subscriber.calls == 0, "an unbound member function is not called");
+
+			bus.Bind<Tick, Subscriber, &Subscriber::OnConst>(&subscriber);
+			bus.Unbind<Tick, Subscriber, &Subscriber::OnConst>(&subscriber);
+			bus.Emit(Tick{ 1 });
+			Check(subscriber.calls == 0, "an unbound const member function is not called");
+
+			bus.Bind<Tick, &OnTickFree>();
+			bus.Unbind<Tick, &OnTickFree>();
+			bus.Emit(Tick{ 1 });
+			Check(freeCalls == 0, "an unbound free function is not called");
+
+			bus.Bind<Tick>(lambda);
+			bus.Unbind<Tick>(lambda);
+			bus.Emit(Tick{ 1 });
+			Check(lambdaCalls == 0, "an unbound lambda is not called");
+
+			// Unbinding one kind leaves the others of the same instance and type alone
+			bus.Bind<Tick, Subscriber, &Subscriber::On>(&subscriber);
+			bus.Bind<Tick, Subscriber, &Subscriber::OnConst>(&subscriber);
+			bus.Unbind<Tick, Subscriber, &Subscriber::OnConst>(&subscriber);
+			bus.Emit(Tick{ 1 });
+			Check(subscriber.calls == 1, "unbinding the const member function keeps the member function");
+			bus.Unbind<Tick, Subscriber, &Subscriber::On>(&subscriber);
+			bus.Emit(Tick{ 1 });
+			Check(subscriber.calls == 1, "nothing is called once both are unbound");
+		}
+	}
+
+	void CheckUnbindRange()
+	{
+		SignalBus bus;
+		std::vector<Subscriber> arena(5);
+		std::vector<Subscriber> others(5);
+		const int bound = BindEveryKind(bus, arena);
+		BindEveryKind(bus, others);
+		bus.Bind<Tick, &OnTickFree>();
+		bus.Bind<Tick>([](const Tick&) { ++lambdaCalls; });
+		freeCalls = lambdaCalls = 0;
+
+		Emit(bus);
+		Check(Calls(arena) == bound && Calls(others) == bound, "every kind of subscription is called once");
+
+		const std::size_t removed = bus.UnbindRange(arena.data(), arena.data() + arena.size());
+		Check(removed == static_cast<std::size_t>(bound), "UnbindRange returns the number of removed subscriptions");
+		Check(!arena[0].node.IsLinked(), "the intrusive node inside the range is unlinked");
+
+		Emit(bus);
+		Check(Calls(arena) == bound, "no subscription inside the range is called any more");
+		Check(Calls(others) == 2 * bound && freeCalls == 2 && lambdaCalls == 2, "the subscriptions outside the range stay bound");
+		Check(bus.UnbindRange(arena.data(), arena.data() + arena.size()) == 0, "a second UnbindRange finds nothing");
+	}
+
+	void CheckUnbindIf()
+	{
+		SignalBus bus;
+		std::vector<Subscriber> pool(5);
+		const int bound = BindEveryKind(bus, pool);
+		bus.Bind<Tick, &OnTickFree>();
+		bus.Bind<Tick>([](const Tick&) { ++lambdaCalls; });
+		freeCalls = lambdaCalls = 0;
+
+		// Only instances 1 and 3: a by-value and a compact subscription
+		const std::size_t removed = bus.UnbindIf([&pool](const void* instance) { return instance == &pool[1] || instance == &pool[3]; });
+		Emit(bus);
+		Check(removed == 2 && pool[1].calls == 0 && pool[3].calls == 0, "UnbindIf removes the matching instances only");
+		Check(Calls(pool) == bound - 2 && pool[0].node.IsLinked(), "the other subscriptions stay bound");
+
+		Check(bus.UnbindIf([](const void* instance) { return instance == nullptr; }) == 1, "free functions are passed nullptr");
+		Emit(bus);
+		Check(freeCalls == 1 && lambdaCalls == 2, "the free function is removed, the lambda is not");
+
+		Check(bus.UnbindIf([](const void*) { return true; }) == static_cast<std::size_t>(bound - 2 + 1), "UnbindIf can remove everything");
+		Emit(bus);
+		Check(Calls(pool) == 2 * (bound - 2) && lambdaCalls == 2 && !pool[0].node.IsLinked(), "nothing is called after removing everything");
+	}
+
+	void CheckForkedBus()
+	{
+		SignalBus bus;
+		std::vector<Subscriber> pool(5);
+		const int bound = BindEveryKind(bus, pool);
+		SignalBus fork = bus.Fork();
+
+		// The node belongs to the original bus and is not forked
+		Check(bus.UnbindRange(pool.data(), pool.data() + pool.size()) == static_cast<std::size_t>(bound), "the original unbinds all of its subscriptions");
+		Emit(fork);
+		Check(Calls(pool) == bound - 1, "the fork keeps its shared subscriptions");
+		Check(fork.UnbindRange(pool.data(), pool.data() + pool.size()) == static_cast<std::size_t>(bound - 1), "the fork unbinds its own copies");
+	}
+}
+
+int main()
+{
+	CheckBindUnbind();
+	CheckUnbindRange();
+	CheckUnbindIf();
+	CheckForkedBus();
+
+	std::printf(failures == 0 ? "all checks passed\n" : "%d checks failed\n", failures);
+	return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,153 @@
+// Prints the records of a flight recording written by FlightRecorder, oldest first.
+// Usage: flight_decode <recording> [last N records]
+// Build: c++ -std=c++17 -I.. flight_decode.cpp -o flight_decode
+
+#include <algorithm>
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#if defined(__GNUG__)
+#include <cxxabi.h>
+#endif
+
+#include "../FlightRecorder.hpp"
+
+namespace
+{
+	std::string Demangle(const char* name)
+	{
+#if defined(__GNUG__)
+		int status = 0;
+		char* demangled = abi::__cxa_demangle(name, nullptr, nullptr, &status);
+		if (status == 0 && demangled != nullptr)
+		{
+			std::string result(demangled);
+			std::free(demangled);
+			return result;
+		}
+#endif
+		return name;
+	}
+
+	bool ReadFile(const char* path, std::vector<unsigned char>& out)
+	{
+		std::FILE* file = std::fopen(path, "rb");
+		if (file == nullptr) return false;
+
+		unsigned char buffer[65536];
+		std::size_t read;
+		while ((read = std::fread(buffer, 1, sizeof(buffer), file)) > 0)
+		{
+			out.insert(out.end(), buffer, buffer + read);
+		}
+		std::fclose(file);
+		return true;
+	}
+}
+
+int main(int argc, char** argv)
+{
+	if (argc < 2)
+	{
+		std::fprintf(stderr, "usage: %s <recording> [last N records]\n", argv[0]);
+		return 2;
+	}
+
+	// Read a private copy; the recording may still be written by a live process
+	std::vector<unsigned char> data;
+	if (!ReadFile(argv[1], data))
+	{
+		std::perror(argv[1]);
+		return 1;
+	}
+	if (data.size() < sizeof(FlightRecordingHeader))
+	{
+		std::fprintf(stderr, "%s: too small for a flight recording\n", argv[1]);
+		return 1;
+	}
+
+	const auto* header = reinterpret_cast<const FlightRecordingHeader*>(data.data());
+	if (std::memcmp(header->magic, FlightRecordingHeader::Magic, sizeof(header->magic)) != 0 ||
+		header->version != FlightRecordingHeader::CurrentVersion)
+	{
+		std::fprintf(stderr, "%s: not a flight recording of a supported version\n", argv[1]);
+		return 1;
+	}
+
+	const std::size_t typesOffset = sizeof(FlightRecordingHeader);
+	const std::size_t recordsOffset = (typesOffset + header->typeCapacity * sizeof(FlightRecordingType) + 63) / 64 * 64;
+	if (data.size() < recordsOffset + header->recordCount * header->recordSize)
+	{
+		std::fprintf(stderr, "%s: truncated recording\n", argv[1]);
+		return 1;
+	}
+
+	std::unordered_map<std::uint32_t, std::string> typeNames;
+	const auto* types = reinterpret_cast<const FlightRecordingType*>(data.data() + typesOffset);
+	const std::uint32_t typeCount = std::min(header->typeCount.load(), header->typeCapacity);
+	for (std::uint32_t i = 0; i < typeCount; ++i)
+	{
+		typeNames[types[i].id] = Demangle(types[i].name);
+	}
+
+	// Collect completely written records; torn ones (begin != end) were interrupted by the crash
+	std::vector<const FlightRecord*> records;
+	std::size_t torn = 0;
+	for (std::uint64_t i = 0; i < header->recordCount; ++i)
+	{
+		const auto* record = reinterpret_cast<const FlightRecord*>(data.data() + recordsOffset + i * header->recordSize);
+		const std::uint64_t begin = record->begin.load();
+		if (begin == 0) continue;
+		if (begin != record->end.load())
+		{
+			++torn;
+			continue;
+		}
+		records.push_back(record);
+	}
+	std::sort(records.begin(), records.end(), [](const FlightRecord* left, const FlightRecord* right)
+	{
+		return left->begin.load() < right->begin.load();
+	});
+
+	std::size_t first = 0;
+	if (argc > 2)
+	{
+		const std::size_t last = std::strtoull(argv[2], nullptr, 10);
+		first = records.size() > last ? records.size() - last : 0;
+	}
+
+	std::printf("%" PRIu64 " emits recorded, %zu kept, %zu torn\n", header->next.load(), records.size(), torn);
+	std::printf("%-10s %-18s %-10s %-40s %s\n", "sequence", "time [ns]", "thread", "type", "payload");
+	for (std::size_t i = first; i < records.size(); ++i)
+	{
+		const FlightRecord* record = records[i];
+		const auto sinceAnchor = static_cast<double>(static_cast<std::int64_t>(record->timestamp - header->anchorTicks)) / header->ticksPerNanosecond;
+		const auto unixNanoseconds = header->anchorUnixNanoseconds + static_cast<std::int64_t>(sinceAnchor);
+
+		const auto name = typeNames.find(record->typeId);
+		char unknown[32];
+		std::snprintf(unknown, sizeof(unknown), "type 0x%08" PRIx32, record->typeId);
+
+		std::printf("%-10" PRIu64 " %-18" PRId64 " %-10" PRIu64 " %-40s ", record->begin.load() - 1, unixNanoseconds, record->thread,
+			name != typeNames.end() ? name->second.c_str() : unknown);
+
+		const auto* payload = reinterpret_cast<const unsigned char*>(record + 1);
+		const std::size_t kept = std::min<std::size_t>(record->eventSize, header->payloadBytes);
+		for (std::size_t byte = 0; byte < kept; ++byte)
+		{
+			std::printf("%02x", payload[byte]);
+		}
+		if (kept < record->eventSize)
+		{
+			std::printf("... (%" PRIu32 " bytes)", record->eventSize);
+		}
+		std::printf("\n");
+	}
+	return 0;
+}